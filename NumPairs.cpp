@@ -1,11 +1,33 @@
 #include "NumPairs.h"
+#include "tileatlas.h"
+#include "sessionlog.h"
 #include <ctime>
 #include <QList>
+#include <QPainter>
+#include <QFileDialog>
+#include <QDataStream>
+#include <QDateTime>
 
 static const int MAX_PLATES_COUNT = 20;
 static const int COLUMN_COUNT = 4; ///< number of Plates columns
 static const QString INITIAL_TIME_LBL_VALUE("00:00:00");
 static const QString INITIAL_CLICK_LBL_VALUE("clicks: 0");
+static const quint16 STATE_VERSION = 1; ///< a version of the saveState() payload format
+static const int BOT_MOVE_DELAY = 700; ///< a pause before a computer's move in mlsec, to let user see it
+
+/*!
+ * \brief opponents user can choose from, the first one means solo playing
+ */
+static const struct {
+    const char *name;
+    int memorySize;     ///< how many Plates the opponent remembers
+    int lookahead;      ///< how many turns the opponent looks ahead
+} OPPONENTS[] = {
+    {"solo", 0, 0},
+    {"cpu: easy", 2, 1},
+    {"cpu: normal", 6, 2},
+    {"cpu: hard", 20, 4},
+};
 
 /*!
  * \brief generates a vector of 'size' size with values for Plates
@@ -20,21 +42,37 @@ static void platesValuesGenerator(QVector<T> &container, const size_t size)
         container.append(T(i));
 }
 
+/*!
+ * \brief evaluates a size of a NumPairs widget
+ * \param [in] difficulty rows of Plates
+ * \return the size to fit all the Plates
+ */
+static QSize boardSize(int difficulty)
+{
+    const int mainWindowWidth = 270;
+    const int mainWindowHeigth = 125 + 50 * difficulty;
+    return QSize(mainWindowWidth, mainWindowHeigth);
+}
+
 /*!
  * \brief initialize a NumPairs object's attributes
  * \param [in] parent just to use Qt memory menagement system
+ * \param [in] isPersistent whether to save the game and to restore a saved one
  */
-NumPairs::NumPairs(QWidget *parent)
-    : QWidget(parent), isOn(false), clicksCounter(0)
+NumPairs::NumPairs(QWidget *parent, bool isPersistent)
+    : QWidget(parent), elapsedOffset(0), shownSeconds(-1),
+      isPersistent(isPersistent), state(QString("NumPairs"), STATE_VERSION),
+      botThread(nullptr), bot(nullptr), opponentLevel(0), isBotTurn(false),
+      turnFlips(0), firstPick(-1), moveSerial(0), userScore(0), botScore(0)
 {
-    timer = new QTimer(this);
-
     resultLay = new QHBoxLayout();
         passedTimeLbl = new QLabel(INITIAL_TIME_LBL_VALUE);
         clicksNumLbl = new QLabel(INITIAL_CLICK_LBL_VALUE);
+        imagesButton = new QPushButton("images");
 
         resultLay->addWidget(passedTimeLbl);
         resultLay->addWidget(clicksNumLbl);
+        resultLay->addWidget(imagesButton);
 
     adjustLay = new QHBoxLayout();
         difficultLbl = new QLabel(QString("choose difficulty: "));
@@ -50,10 +88,18 @@ NumPairs::NumPairs(QWidget *parent)
 
     platesLay = new QGridLayout();
 
-    statusLbl = new QLabel(QString("click \'start\' to begin"));
-    statusLbl->setAlignment(Qt::AlignCenter);
+    statusLay = new QHBoxLayout();
+        statusLbl = new QLabel(QString("click \'start\' to begin"));
+        statusLbl->setAlignment(Qt::AlignCenter);
+        opponentBox = new QComboBox();
+            for (const auto &opponent: OPPONENTS)
+                opponentBox->addItem(QString(opponent.name));
+
+        statusLay->addWidget(statusLbl);
+        statusLay->addWidget(opponentBox);
+
     mainLay = new QVBoxLayout();
-        mainLay->addWidget(statusLbl);
+        mainLay->addLayout(statusLay);
         mainLay->addLayout(resultLay);
         mainLay->addLayout(adjustLay);
         mainLay->addLayout(platesLay);
@@ -61,9 +107,11 @@ NumPairs::NumPairs(QWidget *parent)
     setLayout(mainLay);
 
     connect(startButton, SIGNAL(clicked(bool)), this, SLOT(startButtonClicked()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(passedTimeLblUpdate()));
+    connect(imagesButton, SIGNAL(clicked(bool)), this, SLOT(imagesButtonClicked()));
+    connect(TileAtlas::instance(), SIGNAL(tileReady(QString)), this, SLOT(tileReady(QString)));
 
     setFixedSize(QSize(270, 150));
+    restoreState();                 ///< continue a game interrupted before
 }
 
 /*!
@@ -98,87 +146,245 @@ void NumPairs::platesCreator()
  */
 void NumPairs::startButtonClicked()
 {
-    const int mainWindowWidth = 270;
-    const int mainWindowHeigth = 125 + 50 * this->difficultSpinBox->value();
-    const QSize mainWindowSize(mainWindowWidth, mainWindowHeigth);
+    const QSize mainWindowSize = boardSize(this->difficultSpinBox->value());
 
     for (auto &plate: plates)       ///< hide all the previous (if exist) Plates
       plate->hide();
 
+    boardTiles = tiles;             ///< the images are fixed for the whole game
     this->platesCreator();          ///< create new Plates
     this->platesFiller();           ///< fill them with values
-    this->isOn = true;              ///< set flag that the game is launched
-    for (auto &plate: plates)       ///< let user click the Plates
-        plate->setEnabled(true);
+
+    QVector<int> values;            ///< launch the game
+    values.reserve(plates.size());
+    for (auto &plate: plates)
+        values.append(plate->getValue());
+    board.start(values);
+    this->platesUpdate();           ///< let user click the Plates
 
     this->setFixedSize(mainWindowSize);             ///> expand NumPairs widget to a MainWindow's size
     passedTimeLbl->setText(INITIAL_TIME_LBL_VALUE); ///> set initial values of measuring widgets
     clicksNumLbl->setText(INITIAL_CLICK_LBL_VALUE);
     statusLbl->setText(QString(""));
-    clicksCounter = 0;
     startButton->setText("restart");                ///> user can start a new game clicking startButton
+    elapsedOffset = 0;
+    shownSeconds = 0;
     time.restart();                                 ///> launch the timer
-    timer->start(100);
+    SharedClock::instance()->subscribe(this, SLOT(passedTimeLblUpdate()));
+
+    opponentLevel = opponentBox->currentIndex();    ///> prepare turns if user plays against the computer
+    isBotTurn = false;
+    turnFlips = 0;
+    firstPick = -1;
+    ++moveSerial;                                   ///> replies for the previous game are stale now
+    userScore = botScore = 0;
+    if (opponentLevel) {
+        botCreator();
+        emit botReset(OPPONENTS[opponentLevel].memorySize, OPPONENTS[opponentLevel].lookahead);
+        scoreLblUpdate();
+    }
+
+    saveState();
 }
 
+/*!
+ * \brief creates the computer opponent and its thread if they don't exist yet
+ *
+ * the opponent is created lazily, so solo games don't spend a thread
+ */
+void NumPairs::botCreator()
+{
+    if (bot)
+        return;
+
+    qRegisterMetaType<BoardSnapshot>("BoardSnapshot");  ///> snapshots are passed between threads
+
+    botThread = new QThread(this);
+    bot = new PairsBot();                               ///> no parent: it's moved to another thread
+    bot->moveToThread(botThread);
+
+    connect(botThread, SIGNAL(finished()), bot, SLOT(deleteLater()));
+    connect(this, SIGNAL(botReset(int,int)), bot, SLOT(reset(int,int)));
+    connect(this, SIGNAL(botObserve(BoardSnapshot)), bot, SLOT(observe(BoardSnapshot)));
+    connect(this, SIGNAL(botThink(BoardSnapshot)), bot, SLOT(think(BoardSnapshot)));
+    connect(bot, SIGNAL(moveChosen(int,int)), this, SLOT(botMoved(int,int)));
+
+    botThread->start();
+}
+
+/*!
+ * \brief a private slot to process user's clicks on Plates
+ *
+ * while the computer opponent moves user's clicks are ignored,
+ *      playing against it a Plate opened in the current turn can't be closed by a click
+ */
 void NumPairs::plateClicked()
 {
-    static int openedCount = 0;                                    ///> how many Plates are currently opened
-    const QString clicksCounterLblValue = QString("clicks: %1")
-                                            .arg(++clicksCounter); ///> represent number of clicks on Plates
     Plate *clickedPlate = qobject_cast<Plate*>(sender());          ///> get a signal sender
 
-    if (openedCount >= 2) {         ///> if there are 2 or more currently opened they must be closed
-        for(auto &plate: plates)
-            if (plate->isEnabled())
-                plate->close();
+    if (opponentLevel && (isBotTurn || (turnFlips && clickedPlate->isOpened())))
+        return;
+
+    plateActivated(plates.indexOf(clickedPlate));
+}
+
+/*!
+ * \brief opens or closes a Plate, it is a move of user or of the computer opponent
+ * \param [in] index the Plate to open or close
+ *
+ * the move is made by PairsBoard::activate(), then Plates show the new state
+ */
+void NumPairs::plateActivated(int index)
+{
+    if (!board.activate(index))
+        return;
+
+    platesUpdate();                                 ///> show what has been opened, closed or matched
+    clicksNumLbl->setText(QString("clicks: %1")
+                            .arg(board.clicks()));  ///> show how many clicks have been done
+    checker();                                      ///> check whether the game is done
+
+    if (opponentLevel)
+        turnUpdate(index);
+
+    saveState();                                    ///> a crash or a restart loses nothing
+}
 
-        openedCount = 0;            ///> now no one is opened
+/*!
+ * \brief makes Plates show the board's state
+ *
+ * Plates of done Pairs and all the Plates of a not running game are disabled
+ */
+void NumPairs::platesUpdate()
+{
+    for (int i = 0; i < plates.size(); ++i) {
+        if (board.isOpened(i) && !plates[i]->isOpened())
+            plates[i]->open();
+        else if (!board.isOpened(i) && plates[i]->isOpened())
+            plates[i]->close();
+
+        plates[i]->setEnabled(board.isOn() && !board.isMatched(i));
     }
+}
 
-    if (clickedPlate->isOpened()) { ///> if was opened should be closed
-        clickedPlate->close();
-        --openedCount;
-    } else {                        ///> if was closed should be opened
-        clickedPlate->open();
-        ++openedCount;
+/*!
+ * \brief counts points and passes turns playing against the computer opponent
+ * \param [in] index the Plate just opened
+ *
+ * a done Pair gives a point and one more turn,
+ *      otherwise the turn passes after two Plates are opened
+ * the opponent is shown every move, so it can remember what it has seen
+ */
+void NumPairs::turnUpdate(int index)
+{
+    if (board.isMatched(index)) {                   ///> a Pair is done
+        ++(isBotTurn ? botScore : userScore);
+        turnFlips = 0;
+        firstPick = -1;
+    } else if (++turnFlips == 2) {                  ///> a miss, the turn passes
+        turnFlips = 0;
+        firstPick = -1;
+        isBotTurn = !isBotTurn;
+    } else {
+        firstPick = index;
     }
 
-    checker(clickedPlate);                          ///> check opened Plates whether some of them are matched
-    clicksNumLbl->setText(clicksCounterLblValue);   ///> show how many clicks have been done
+    emit botObserve(snapshot());
+    scoreLblUpdate();
+
+    if (board.isOn() && isBotTurn)
+        QTimer::singleShot(BOT_MOVE_DELAY, this, SLOT(requestBotMove()));
+}
+
+/*!
+ * \brief shows the score and whose turn it is, or who has won if the game is done
+ */
+void NumPairs::scoreLblUpdate()
+{
+    QString res = QString("%1 : %2 ").arg(userScore).arg(botScore);
+
+    if (board.isOn())
+        res += isBotTurn ? QString("cpu\'s turn") : QString("your turn");
+    else if (userScore > botScore)
+        res += QString("you won");
+    else if (userScore < botScore)
+        res += QString("cpu won");
+    else
+        res += QString("draw");
+
+    statusLbl->setText(res);
 }
 
 /*!
- * \brief checks opened Plate whether their values are the same
- * \param [in] plate a Plate object that was clicked and is to be checked
- *      whether one more with the same value is opened
+ * \brief a private slot asking the computer opponent for a move
  *
- * if there are no Plates left to open and match
- *  the play is done
+ * the opponent gets a snapshot, so it never touches the widgets
  */
-void NumPairs::checker(Plate *plate)
+void NumPairs::requestBotMove()
 {
-    bool isDone = true;
+    if (!board.isOn() || !isBotTurn)
+        return;
 
-    for (auto &iter: plates) {      ///> check whether there is one more Plate with the same value opened
-        if (iter->isOpened() &&
-            iter->isEnabled() &&
-            iter != plate &&
-            iter->getValue() == plate->getValue())
-        {
-            iter->setEnabled(false);    ///> if found
-            plate->setEnabled(false);   ///> make both opened and disabled (a Pair is done)
-        }
+    ++moveSerial;
+    emit botThink(snapshot());
+}
 
-        if ( !(iter->isOpened()) ) ///> if at least one Plate is closed
-            isDone = false;        ///> the game is not completed
-    }
+/*!
+ * \brief a private slot applying a move of the computer opponent
+ * \param [in] serial the id of the request the move replies to
+ * \param [in] index the Plate to open
+ */
+void NumPairs::botMoved(int serial, int index)
+{
+    if (serial != moveSerial || !board.isOn() || !isBotTurn)    ///> a reply for a restarted game or a lost turn
+        return;
+    if (index == firstPick)
+        return;
+
+    plateActivated(index);                          ///> the board ignores a wrong index
+}
 
-    if (isDone) {                                       ///> if isDone == true the game is done
-        timer->stop();                                  ///> stop the timer
-        this->startButton->setText(QString("start"));   ///> offer a new game
-        statusLbl->setText(QString("you\'ve done"));    ///> let user know they have won
+/*!
+ * \brief takes what a player can see on the board
+ * \return values of opened Plates and done Pairs
+ */
+BoardSnapshot NumPairs::snapshot() const
+{
+    BoardSnapshot shot;
+
+    shot.serial = moveSerial;
+    shot.firstPick = firstPick;
+    shot.values.reserve(board.size());
+    shot.matched.reserve(board.size());
+    for (int i = 0; i < board.size(); ++i) {
+        shot.values.append(board.isOpened(i) ? board.value(i) : -1);
+        shot.matched.append(board.isMatched(i));
     }
+
+    return shot;
+}
+
+/*!
+ * \brief finishes the game if PairsBoard says there are no Plates left to open and match
+ */
+void NumPairs::checker()
+{
+    if (board.isOn())
+        return;
+
+    SharedClock::instance()->unsubscribe(this, SLOT(passedTimeLblUpdate())); ///> stop the timer
+
+    SessionRecord record;                           ///> log the round for analysis
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.game = QString("NumPairs");
+    record.difficulty = board.size() / COLUMN_COUNT;   ///> the spin box may be changed during the game
+    record.opponent = QString(OPPONENTS[opponentLevel].name);
+    record.clicks = board.clicks();
+    record.elapsed = time.elapsed() + elapsedOffset;
+    SessionExporter::instance()->append(record);
+
+    this->startButton->setText(QString("start"));   ///> offer a new game
+    statusLbl->setText(QString("you\'ve done"));    ///> let user know they have won
 }
 
 /*!
@@ -210,6 +416,7 @@ void NumPairs::platesFiller()
             int plateNum = places[place];           ///> take the randomly choosen cell's value (a place)
 
             plates[plateNum]->setValue(it);         ///> set value for a randomly choosen Plate
+            plates[plateNum]->setTile(it < boardTiles.size() ? boardTiles[it] : QString()); ///> and its image if there is enough
             places.erase(places.begin() + place);   ///> and delete the choosen place from queue of places of Plates
         }
 }
@@ -219,7 +426,11 @@ void NumPairs::platesFiller()
  */
 void NumPairs::passedTimeLblUpdate()
 {
-    const qint64 timePassed_sec = time.elapsed() / 1000;                    ///> get elapsed time from the beginig in secs
+    const qint64 timePassed_sec = (time.elapsed() + elapsedOffset) / 1000;  ///> get elapsed time from the beginig in secs
+    if (timePassed_sec == shownSeconds)                                     ///> nothing to repaint, it's the case of most ticks
+        return;
+    shownSeconds = timePassed_sec;
+
     const qint64 hours = timePassed_sec / 3600;                             ///> get hours
     const qint64 minutes = (timePassed_sec - hours * 3600) / 60;            ///> get minutes
     const qint64 seconds = timePassed_sec - hours * 3600 - minutes * 60;    ///> get seconds
@@ -232,7 +443,190 @@ void NumPairs::passedTimeLblUpdate()
     passedTimeLbl->setText(res);
 }
 
+/*!
+ * \brief lets user choose image files to show on Plates instead of numbers
+ *
+ * the files are sent to TileAtlas at once, so they are being decoded
+ *      in background while user is going to start a game
+ * the images take effect since the next start
+ */
+void NumPairs::imagesButtonClicked()
+{
+    tiles = QFileDialog::getOpenFileNames(this, QString("choose images"), QString(),
+                                          QString("Images (*.png *.jpg *.jpeg *.bmp *.gif)"));
+
+    for (const auto &path: tiles)       ///> non-blocking, the atlas decodes on its own threads
+        TileAtlas::instance()->request(path);
+
+    statusLbl->setText(tiles.isEmpty() ? QString("numbers are used")
+                                       : QString("%1 images chosen").arg(tiles.size()));
+}
+
+/*!
+ * \brief refreshes opened Plates which tile has just been decoded
+ * \param [in] path the decoded image file
+ */
+void NumPairs::tileReady(const QString &path)
+{
+    for (auto &plate: plates)
+        if (plate->isOpened() && plate->getTile() == path)
+            plate->open();              ///> replaces the number with the tile
+}
+
+/*!
+ * \brief writes the game in progress to the state file
+ *
+ * the payload (STATE_VERSION 1) is: the board's difficulty, opponent, turn, elapsed mlsecs,
+ *      counters, the board's image files and a value and a flags byte per Plate
+ * a done or not started game clears the file
+ */
+void NumPairs::saveState()
+{
+    if (!isPersistent)
+        return;
+    if (!board.isOn()) {
+        state.clear();
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(GameStateFile::STREAM_VERSION);
+
+    out << quint8(board.size() / COLUMN_COUNT) << quint8(opponentLevel)
+        << quint8(isBotTurn) << quint8(turnFlips) << qint8(firstPick) << quint8(board.openedCount())
+        << qint32(board.clicks()) << qint32(userScore) << qint32(botScore)
+        << qint64(time.elapsed() + elapsedOffset) << boardTiles;
+
+    out << quint8(board.size());
+    for (int i = 0; i < board.size(); ++i)          ///> bit 0 is opened, bit 1 is a done Pair
+        out << quint8(board.value(i))
+            << quint8((board.isOpened(i) ? 1 : 0) | (board.isMatched(i) ? 2 : 0));
+
+    state.save(payload);
+}
+
+/*!
+ * \brief checks whether there is a game to continue
+ * \return whether the state file has a valid record of the current version
+ */
+bool NumPairs::hasSavedState()
+{
+    return GameStateFile::hasRecord(QString("NumPairs"), STATE_VERSION);
+}
+
+/*!
+ * \brief continues a game from the state file if there is a valid one
+ *
+ * the computer opponent's memory is not saved, it starts remembering anew
+ */
+void NumPairs::restoreState()
+{
+    if (!isPersistent)
+        return;
+
+    const QByteArray payload = state.load();
+    if (payload.isEmpty())
+        return;
+
+    QDataStream in(payload);
+    in.setVersion(GameStateFile::STREAM_VERSION);
+    quint8 difficulty = 0, level = 0, botTurn = 0, flips = 0, opened = 0, count = 0;
+    qint8 first = -1;
+    qint32 clicks = 0, uScore = 0, bScore = 0;
+    qint64 elapsed = 0;
+    QStringList savedTiles;
+
+    in >> difficulty >> level >> botTurn >> flips >> first >> opened
+       >> clicks >> uScore >> bScore >> elapsed >> savedTiles >> count;
+
+    QVector<int> values(count);
+    QVector<bool> isOpened(count), isMatched(count);
+    for (int i = 0; i < count; ++i) {
+        quint8 value = 0, flags = 0;
+        in >> value >> flags;
+        values[i] = value;
+        isOpened[i] = flags & 1;
+        isMatched[i] = flags & 2;
+    }
+
+    const int levelsCount = int(sizeof(OPPONENTS) / sizeof(OPPONENTS[0]));
+    if (in.status() != QDataStream::Ok || difficulty < difficultSpinBox->minimum()
+            || difficulty > difficultSpinBox->maximum() || count != difficulty * COLUMN_COUNT
+            || level >= levelsCount || flips > 1 || first < -1 || first >= count
+            || (level && (flips == 1) != (first >= 0))     ///> the first Plate of a turn is opened and not done
+            || (first >= 0 && (!isOpened[first] || isMatched[first]))
+            || !board.restore(values, isOpened, isMatched, opened, clicks))
+        return;                     ///> a broken state, just start anew
+
+    difficultSpinBox->setValue(difficulty);
+    opponentBox->setCurrentIndex(level);
+    tiles = boardTiles = savedTiles;
+    for (const auto &path: boardTiles)
+        TileAtlas::instance()->request(path);
+
+    platesCreator();
+    for (int i = 0; i < count; ++i) {
+        plates[i]->setValue(values[i]);
+        plates[i]->setTile(values[i] < boardTiles.size() ? boardTiles[values[i]] : QString());
+    }
+    platesUpdate();
+
+    elapsedOffset = elapsed;
+    shownSeconds = -1;
+    time.restart();
+    SharedClock::instance()->subscribe(this, SLOT(passedTimeLblUpdate()));
+
+    setFixedSize(boardSize(difficulty));
+    clicksNumLbl->setText(QString("clicks: %1").arg(board.clicks()));
+    statusLbl->setText(QString(""));
+    startButton->setText("restart");
+    passedTimeLblUpdate();
+
+    opponentLevel = level;
+    isBotTurn = botTurn;
+    turnFlips = flips;
+    firstPick = first;
+    userScore = uScore;
+    botScore = bScore;
+    if (opponentLevel) {
+        botCreator();
+        emit botReset(OPPONENTS[opponentLevel].memorySize, OPPONENTS[opponentLevel].lookahead);
+        emit botObserve(snapshot());
+        scoreLblUpdate();
+        if (isBotTurn)
+            QTimer::singleShot(BOT_MOVE_DELAY, this, SLOT(requestBotMove()));
+    }
+}
+
 NumPairs::~NumPairs()
 {
+    saveState();                    ///< keep the elapsed time of an unfinished game
+    if (botThread) {                ///> the bot is deleted when its thread finishes
+        botThread->quit();
+        botThread->wait();
+    }
+}
+
+/*!
+ * \brief Plate::hasReadyTile
+ * \return whether the Plate has a tile and TileAtlas can draw it
+ */
+bool Plate::hasReadyTile() const
+{
+    return !_tile.isEmpty() && TileAtlas::instance()->isReady(_tile);
+}
+
+/*!
+ * \brief paints the button and the tile over it if the Plate is opened
+ * \param [in] event is passed to QPushButton::paintEvent()
+ */
+void Plate::paintEvent(QPaintEvent *event)
+{
+    QPushButton::paintEvent(event);
 
+    if (_isOpened && hasReadyTile()) {
+        QPainter painter(this);
+        TileAtlas::instance()->draw(&painter, rect(), _tile);
+    }
 }
@@ -11,6 +11,13 @@
 #include <QSpinBox>
 #include <QTimer>
 #include <QTime>
+#include <QStringList>
+#include <QComboBox>
+#include <QThread>
+#include "pairsbot.h"
+#include "gamestate.h"
+#include "pairsboard.h"
+#include "sharedclock.h"
 
 
 class Plate;
@@ -29,6 +36,17 @@ class Plate;
  * if user opens two Plates with the same value they remain opened and get disabled for clicks
  * if there are no closed Plate user wins
  * clicks and time are being counted
+ * instead of numbers Plates can show images chosen by user (see TileAtlas)
+ *
+ * user can play against a computer opponent (see PairsBot):
+ *      players open two Plates a turn, a done Pair gives a point and one more turn,
+ *      the opponent thinks in its own thread and its moves come back through queued signals
+ *
+ * a game in progress is saved on every move and is restored by the next NumPairs object
+ *      (unless the object is not persistent, f.i. in Arena)
+ * the passed time is updated by SharedClock
+ *
+ * the rules themselves are kept by PairsBoard, Plates just show its state
  *
  * see NumPairs.cpp
  */
@@ -36,28 +54,59 @@ class NumPairs : public QWidget
 {
     Q_OBJECT
 public:
-    NumPairs(QWidget *parent = nullptr);
+    NumPairs(QWidget *parent = nullptr, bool isPersistent = true);
     ~NumPairs() override;
+    static bool hasSavedState();    ///< see NumPairs.cpp
 private slots:
     void plateClicked();
     void startButtonClicked();
     void passedTimeLblUpdate();
+    void imagesButtonClicked();
+    void tileReady(const QString &path);
+    void requestBotMove();
+    void botMoved(int serial, int index);
+signals:
+    void botReset(int memorySize, int lookahead);   ///< is delivered to the PairsBot's thread
+    void botObserve(const BoardSnapshot &shot);     ///< is delivered to the PairsBot's thread
+    void botThink(const BoardSnapshot &shot);       ///< is delivered to the PairsBot's thread
 private:
     void platesCreator();
     void platesFiller();
-    void checker(Plate*);
+    void checker();
+    void platesUpdate();
+    void plateActivated(int index);
+    void turnUpdate(int index);
+    void scoreLblUpdate();
+    void botCreator();
+    BoardSnapshot snapshot() const;
+    void saveState();
+    void restoreState();
 
-    QHBoxLayout *resultLay, *adjustLay;
+    QHBoxLayout *statusLay, *resultLay, *adjustLay;
     QGridLayout *platesLay;
     QVBoxLayout *mainLay;
     QLabel *difficultLbl, *clicksNumLbl, *passedTimeLbl, *statusLbl;
     QSpinBox *difficultSpinBox;
-    QPushButton *startButton;
+    QComboBox *opponentBox;     ///< solo or a computer opponent's level
+    QPushButton *startButton, *imagesButton;
     QVector<Plate*> plates;
-    QTimer *timer;
+    QStringList tiles;      ///< image files for Plates' values, a value is an index here
+    QStringList boardTiles; ///< tiles the current board was filled with (tiles may be changed during a game)
     QTime time;
-    bool isOn;
-    int clicksCounter;
+    qint64 elapsedOffset;       ///< mlsecs played before the game was restored
+    qint64 shownSeconds;        ///< what passedTimeLbl shows, -1 if nothing
+    PairsBoard board;           ///< the game's state, Plates show it
+    bool isPersistent;          ///< whether the game is saved and restored
+    GameStateFile state;        ///< the game in progress
+
+    QThread *botThread;         ///< is created with the opponent on the first game against it
+    PairsBot *bot;              ///< lives in botThread
+    int opponentLevel;          ///< index in opponentBox for the current game, 0 is solo
+    bool isBotTurn;
+    int turnFlips;              ///< Plates opened in the current turn
+    int firstPick;              ///< index of the Plate opened first in the current turn, -1 if none
+    int moveSerial;             ///< id of the last move requested from the bot, stale replies are ignored
+    int userScore, botScore;    ///< done Pairs
 };
 
 /*!
@@ -65,6 +114,8 @@ private:
  *
  * it has a number witch can be shown(opened) or
  *      replaced with 'X' (closed) throu this->setText(("X"/"number"))
+ * if a tile (an image file) is set and already decoded by TileAtlas
+ *      the opened Plate shows the image instead of the number
  */
 class Plate: public QPushButton
 {
@@ -92,6 +143,18 @@ public:
      */
     void setValue(const int value) {_value = value;}
 
+    /*!
+     * \brief Java stylish setter
+     * \param [in] path an image file to show instead of the value (empty for the value)
+     */
+    void setTile(const QString &path) {_tile = path;}
+
+    /*!
+     * \brief Java stylish getter
+     * \return an image file shown instead of the value
+     */
+    const QString &getTile() const {return _tile;}
+
     /*!
      * \brief Java stylish getter
      * \return is a Plate's text the value or "X"
@@ -103,8 +166,12 @@ public:
      */
     void open()
     {
-        this->setText(QString::number(this->getValue()));
+        if (hasReadyTile())
+            this->setText(QString());   ///< the tile is painted in paintEvent()
+        else
+            this->setText(QString::number(this->getValue()));
         _isOpened = true;
+        this->update();
     }
 
     /*!
@@ -116,9 +183,15 @@ public:
          _isOpened = false;
     }
 
+protected:
+    void paintEvent(QPaintEvent *event) override;   ///< see NumPairs.cpp
+
 private:
+    bool hasReadyTile() const;                      ///< see NumPairs.cpp
+
     int _value;
     bool _isOpened;
+    QString _tile;
 };
 
 #endif // NUMPAIRS_H
@@ -1,19 +1,23 @@
 #include "Numem.h"
+#include "sessionlog.h"
 #include <cstdlib>
 #include <ctime>
+#include <QDataStream>
+#include <QDateTime>
 
 const int MEMORIZING_TIME = 5000; ///< time for user to memorize the number in mlsec
+const quint16 STATE_VERSION = 1;  ///< a version of the saveState() payload format
 
 /*!
  * \brief initialize widgets and other attributes of a Numem object
  * \param [in] parent is used to delegate memory management
  * \param [in] rand default size of a number to remember
+ * \param [in] isPersistent whether to save a generated number and to restore a saved one
  */
-Numem::Numem(QWidget *parent, unsigned rand)
-    : QWidget(parent), isGenerated(false), randSize(rand)
+Numem::Numem(QWidget *parent, unsigned rand, bool isPersistent)
+    : QWidget(parent), memorizeDeadline(0), randSize(rand),
+      isPersistent(isPersistent), state(QString("Numem"), STATE_VERSION)
 {
-    memorizeTimer = new QTimer(this);
-
     difficulty = new QSpinBox(this);
     difficulty->setDisplayIntegerBase(10);
     difficulty->setMaximum(10);
@@ -50,9 +54,10 @@ Numem::Numem(QWidget *parent, unsigned rand)
 
     connect(actionButton, SIGNAL(clicked(bool)), this, SLOT(actionButtonClicked()));
     connect(difficulty, SIGNAL(valueChanged(int)), this, SLOT(setRandSize(int)));
-    connect(memorizeTimer, SIGNAL(timeout()), this, SLOT(memorizeTimeOut()));
+    connect(numInput, SIGNAL(textEdited(QString)), this, SLOT(saveState()));   ///< every typed digit survives a crash
 
     setFixedSize(QSize(270, 150));
+    restoreState();     ///< continue checking a number generated before
 }
 
 /*!
@@ -80,13 +85,23 @@ void Numem::memorizeTimeOut()
     QString forFill;
     forFill.reserve(10); ///< the max size is 10
 
-    for (int i = 0; i < curNum.size(); ++i)
+    round.hide();
+    for (int i = 0; i < round.number().size(); ++i)
         forFill.append("*");
     numToRemember->setText(forFill);
 
     numInput->setEnabled(true);
     actionButton->setEnabled(true);
-    memorizeTimer->stop();
+    SharedClock::instance()->unsubscribe(this, SLOT(clockTicked()));
+}
+
+/*!
+ * \brief checks on every SharedClock's tick whether the memorizing time is over
+ */
+void Numem::clockTicked()
+{
+    if (SharedClock::instance()->now() >= memorizeDeadline)
+        memorizeTimeOut();
 }
 
 /*!
@@ -118,17 +133,12 @@ void Numem::setRandSize(int rsize)
  */
 void Numem::actionButtonClicked()
 {
-    if (isGenerated) {
-        QString forFill;                        ///< QWidget::setText takes QString objects only
-        forFill.reserve(10);                    ///< prepare a place for a number
-        for (int i = 0; i < curNum.size(); ++i)
-            forFill.append(curNum[i]);          ///< QVector<QChar> into QString
-        numToRemember->setText(forFill);        ///< finally set text to show a number that was generated
-
-        int errorsCounter = 0; ///< checking number of errors
-        for (int i = 0; i < curNum.size(); ++i)
-            if (curNum[i] != numInput->text()[i])
-                ++errorsCounter;
+    if (round.isGenerated()) {
+        const int errorsCounter = round.check(numInput->text()); ///< a short input is checked safely, missing digits are errors
+        if (errorsCounter < 0)                  ///< still memorizing
+            return;
+
+        numToRemember->setText(round.number()); ///< show a number that was generated
 
         if (errorsCounter == 1)                                            ///< if one then 'error'
             resultLbl->setText(QString::number(errorsCounter) + " error");
@@ -137,18 +147,23 @@ void Numem::actionButtonClicked()
         else                                                               ///< if no errors then just excellent
             resultLbl->setText("excellent");
 
+        SessionRecord record;                                              ///< log the round for analysis
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        record.game = QString("Numem");
+        record.difficulty = difficulty->value();
+        record.errors = errorsCounter;
+        record.length = round.number().size();
+        SessionExporter::instance()->append(record);
+
         /// prepare widgets for a next playing
         actionButton->setText("generate a number"); ///< now actionButton is responsible for generation, not checking
         actionButton->setEnabled(true);             ///< ready to generate a new number
         numInput->setEnabled(false);                ///< user can't input anything, because nothing was generated
         difficulty->setEnabled(true);               ///<  user can change difficulty
-        isGenerated = false;                        ///< sets flag == 'nothing is generated'
+        saveState();                                ///< nothing to continue now
     } else {
         QString random = getRandomString(randSize); ///< get a new generated number for memorising
-        curNum.erase(curNum.begin(), curNum.end()); ///< erase the previous one
-
-        for (int i = 0; i < random.size(); ++i)     ///< save it
-            curNum.append(random[i]);
+        round.generate(random);                     ///< save it, the previous one is replaced
 
         numToRemember->setText(random);             ///< show the generated number to user
         numInput->setText("");                      ///< set user's widget for input clear
@@ -158,12 +173,80 @@ void Numem::actionButtonClicked()
         actionButton->setText("check");             ///< now actionButton is responsible for checking, not generation
         actionButton->setEnabled(false);            ///< user can't submit while the timer doesn't expire
         resultLbl->setText("");                     ///< clear result's label
-        isGenerated = true;                         ///< set flag == 'the number was generated'
-        memorizeTimer->start(MEMORIZING_TIME);      ///< launch the timer
+        memorizeDeadline = SharedClock::instance()->now() + MEMORIZING_TIME;   ///< launch the timer
+        SharedClock::instance()->subscribe(this, SLOT(clockTicked()));
+        saveState();                                ///< the number survives a restart
     }
 }
 
+/*!
+ * \brief writes a generated number to the state file
+ *
+ * is called on every edit of user's input too
+ * the payload (STATE_VERSION 1) is: difficulty, the number and user's input
+ * if nothing is generated the file is cleared
+ */
+void Numem::saveState()
+{
+    if (!isPersistent)
+        return;
+    if (!round.isGenerated()) {
+        state.clear();
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(GameStateFile::STREAM_VERSION);
+    out << quint8(randSize) << round.number() << numInput->text();
+
+    state.save(payload);
+}
+
+/*!
+ * \brief checks whether there is a number to check
+ * \return whether the state file has a valid record of the current version
+ */
+bool Numem::hasSavedState()
+{
+    return GameStateFile::hasRecord(QString("Numem"), STATE_VERSION);
+}
+
+/*!
+ * \brief continues a game from the state file if there is a valid one
+ *
+ * the number is hidden at once, the memorizing time is over
+ */
+void Numem::restoreState()
+{
+    if (!isPersistent)
+        return;
+
+    const QByteArray payload = state.load();
+    if (payload.isEmpty())
+        return;
+
+    QDataStream in(payload);
+    in.setVersion(GameStateFile::STREAM_VERSION);
+    quint8 size = 0;
+    QString number, input;
+
+    in >> size >> number >> input;
+    if (in.status() != QDataStream::Ok || number.isEmpty() || size > difficulty->maximum())
+        return;                                     ///< a broken state, just start anew
+
+    difficulty->setValue(size);                     ///< sets randSize too
+    round.restore(number);
+
+    numInput->setText(input);
+    difficulty->setEnabled(false);
+    actionButton->setText("check");
+    resultLbl->setText("");
+    memorizeTimeOut();                              ///< hide the number and let user input
+}
+
 Numem::~Numem()
 {
+    saveState();        ///< keep user's input of an unchecked number
 
 }
@@ -9,7 +9,9 @@
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QVector>
-#include <QTimer>
+#include "gamestate.h"
+#include "numemround.h"
+#include "sharedclock.h"
 
 /*!
  * \class Numem
@@ -20,6 +22,9 @@
  * after a while the randomly generated int is hidden
  * and you should input the number you remember
  * after user submitted the result is shown
+ * the round's state is kept by NumemRound
+ * a generated number is saved, so it can be checked after a restart
+ *      (unless the object is not persistent, f.i. in Arena)
  */
 
 class Numem : public QWidget
@@ -27,8 +32,9 @@ class Numem : public QWidget
     Q_OBJECT
 
 public:
-    Numem(QWidget *parent = nullptr, unsigned rand = 5); ///< see Numem.cpp
+    Numem(QWidget *parent = nullptr, unsigned rand = 5, bool isPersistent = true); ///< see Numem.cpp
     ~Numem();
+    static bool hasSavedState();                    ///< see Numem.cpp
 private:
     QVBoxLayout *mainLay;                           ///< contains all the other layouts, used in this->setLayout()
     QHBoxLayout *serviceLay, *inputLay, *memLay;
@@ -36,15 +42,20 @@ private:
     QSpinBox *difficulty;                           ///< defficulty level corresponds to a number of digits to remember (f.i. 2 level -> 2 digits to remember)
     QLineEdit *numInput;                            ///< for input the memorized number to check
     QPushButton *actionButton;                      ///< to generate a new number or submit your input
-    QTimer *memorizeTimer;                          ///< implements time restriction for memorizing a generated number
+    qint64 memorizeDeadline;                        ///< implements time restriction for memorizing a generated number, in SharedClock::now() mlsecs
 
-    bool isGenerated;                               ///< is used to check an internal state of the game to define actionButton logics
+    NumemRound round;                               ///< is used to check an internal state of the game to define actionButton logics
     unsigned randSize;                              ///< size of the generated number, is used to truncate gotten random int
-    QVector<QChar> curNum,                          ///< what to memorize
-                   clientInput;                     ///< user's input
+    QVector<QChar> clientInput;                     ///< user's input
+    bool isPersistent;                              ///< whether the game is saved and restored
+    GameStateFile state;                            ///< a generated and not checked number
+
+    void restoreState();                            ///< see Numem.cpp
 private slots:
+    void saveState();                               ///< see Numem.cpp
     void actionButtonClicked();                     ///< see Numem.cpp
     void memorizeTimeOut();                         ///< see Numem.cpp
+    void clockTicked();                             ///< see Numem.cpp
     void setRandSize(int rsize);                    ///< the number of digits to remember
 };
 
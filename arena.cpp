@@ -0,0 +1,95 @@
+#include "arena.h"
+#include "NumPairs.h"
+#include "Numem.h"
+
+static const int ARENA_COLUMNS = 4;     ///< boards in a row
+static const int MAX_BOARDS = 48;
+static const int INITIAL_BOARDS = 12;
+
+/*!
+ * \brief games a board can play, "mixed" alternates them
+ */
+enum ArenaGames {
+    NumPairsBoards,
+    NumemBoards,
+    MixedBoards
+};
+
+/*!
+ * \brief initializes widgets of an Arena object and fills it with boards
+ * \param [in] parent is used to delegate memory management
+ */
+Arena::Arena(QWidget *parent)
+    : QWidget(parent)
+{
+    adjustLay = new QHBoxLayout();
+        countLbl = new QLabel(QString("boards: "));
+        countSpinBox = new QSpinBox();
+            countSpinBox->setMinimum(1);
+            countSpinBox->setMaximum(MAX_BOARDS);
+            countSpinBox->setValue(INITIAL_BOARDS);
+        gameBox = new QComboBox();
+            gameBox->addItem(QString("NumPairs"));  ///< in ArenaGames order
+            gameBox->addItem(QString("Numem"));
+            gameBox->addItem(QString("mixed"));
+        fillButton = new QPushButton("fill");
+
+        adjustLay->addWidget(countLbl);
+        adjustLay->addWidget(countSpinBox);
+        adjustLay->addWidget(gameBox);
+        adjustLay->addWidget(fillButton);
+        adjustLay->addStretch();
+
+    boardsWidget = new QWidget();
+    boardsLay = new QGridLayout(boardsWidget);
+    scrollArea = new QScrollArea();
+        scrollArea->setWidgetResizable(true);
+        scrollArea->setWidget(boardsWidget);
+
+    mainLay = new QVBoxLayout();
+        mainLay->addLayout(adjustLay);
+        mainLay->addWidget(scrollArea);
+
+    setLayout(mainLay);
+
+    connect(fillButton, SIGNAL(clicked(bool)), this, SLOT(fillButtonClicked()));
+
+    fillButtonClicked();
+}
+
+/*!
+ * \brief replaces the boards with new ones of the chosen game and number
+ *
+ * updates are disabled while boards are being created and laid out,
+ *      so there is one repaint instead of one per board
+ */
+void Arena::fillButtonClicked()
+{
+    const int count = countSpinBox->value();
+    const int game = gameBox->currentIndex();
+
+    boardsWidget->setUpdatesEnabled(false);
+
+    for (auto &board: boards) {                 ///< delete all the previous boards
+        boardsLay->removeWidget(board);
+        delete board;
+    }
+    boards.clear();
+    boards.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const bool isNumPairs = game == NumPairsBoards || (game == MixedBoards && i % 2 == 0);
+        QWidget *board = isNumPairs ? static_cast<QWidget*>(new NumPairs(boardsWidget, false))
+                                    : static_cast<QWidget*>(new Numem(boardsWidget, 5, false));
+
+        boards.append(board);
+        boardsLay->addWidget(board, i / ARENA_COLUMNS, i % ARENA_COLUMNS, Qt::AlignLeft | Qt::AlignTop);
+    }
+
+    boardsWidget->setUpdatesEnabled(true);
+}
+
+Arena::~Arena()
+{
+
+}
@@ -0,0 +1,47 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QGridLayout>
+#include <QVector>
+
+/*!
+ * \brief Arena tiles many independent games in one window (for group sessions and kiosks)
+ *
+ * user chooses how many boards of which game to show and clicks 'fill'
+ * the boards are not persistent (they don't touch the state files)
+ *      and share SharedClock instead of a timer each,
+ *      so an idle arena costs one timer event per tick
+ * boards are replaced with updates disabled, so the arena is repainted once
+ *
+ * see arena.cpp
+ */
+class Arena : public QWidget
+{
+    Q_OBJECT
+public:
+    Arena(QWidget *parent = nullptr);   ///< see arena.cpp
+    ~Arena() override;
+private slots:
+    void fillButtonClicked();           ///< see arena.cpp
+private:
+    QVBoxLayout *mainLay;
+    QHBoxLayout *adjustLay;
+    QLabel *countLbl;
+    QSpinBox *countSpinBox;             ///< how many boards to show
+    QComboBox *gameBox;                 ///< which game the boards play
+    QPushButton *fillButton;
+    QScrollArea *scrollArea;
+    QWidget *boardsWidget;              ///< contains the boards, is scrolled in scrollArea
+    QGridLayout *boardsLay;
+    QVector<QWidget*> boards;
+};
+
+#endif // ARENA_H
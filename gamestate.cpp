@@ -0,0 +1,126 @@
+#include "gamestate.h"
+#include <QStandardPaths>
+#include <QDataStream>
+#include <QDir>
+
+const int GameStateFile::STREAM_VERSION;
+
+static const quint32 STATE_MAGIC = 0x4D475354;  ///< "MGST"
+static const int HEADER_SIZE = 12;              ///< magic, version, checksum and payload size
+
+/*!
+ * \brief gives the path of a game's state file
+ * \param [in] name a game's name
+ * \return (name).state in the application's data directory
+ */
+static QString statePath(const QString &name)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/" + name + ".state";
+}
+
+/*!
+ * \brief checks a stored record
+ * \param [in] record the whole content of a state file
+ * \param [in] version the expected version of the payload format
+ * \return the payload or an empty QByteArray if the record is not valid or of another version
+ */
+static QByteArray payloadOf(const QByteArray &record, quint16 version)
+{
+    QDataStream in(record);
+    in.setVersion(GameStateFile::STREAM_VERSION);
+    quint32 magic = 0, size = 0;
+    quint16 recordVersion = 0, checksum = 0;
+
+    in >> magic >> recordVersion >> checksum >> size;
+    if (in.status() != QDataStream::Ok || magic != STATE_MAGIC || recordVersion != version
+            || quint32(record.size() - HEADER_SIZE) != size)
+        return QByteArray();
+
+    const QByteArray payload = record.mid(HEADER_SIZE);
+    if (qChecksum(payload.constData(), uint(payload.size())) != checksum)
+        return QByteArray();
+
+    return payload;
+}
+
+/*!
+ * \brief GameStateFile::GameStateFile prepares a state file, nothing is read or written yet
+ * \param [in] name a game's name, the file is (name).state in the application's data directory
+ * \param [in] version a version of the game's payload format
+ */
+GameStateFile::GameStateFile(const QString &name, quint16 version)
+    : _version(version)
+{
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    file.setFileName(statePath(name));
+}
+
+/*!
+ * \brief GameStateFile::hasRecord checks for a saved game without creating anything
+ * \param [in] name a game's name
+ * \param [in] version a version of the game's payload format
+ * \return whether the state file exists and has a valid record of this version
+ */
+bool GameStateFile::hasRecord(const QString &name, quint16 version)
+{
+    QFile file(statePath(name));
+    return file.open(QIODevice::ReadOnly) && !payloadOf(file.readAll(), version).isEmpty();
+}
+
+/*!
+ * \brief GameStateFile::openFile opens the file once, then it stays opened
+ * \return whether the file is opened
+ */
+bool GameStateFile::openFile()
+{
+    return file.isOpen() || file.open(QIODevice::ReadWrite);
+}
+
+/*!
+ * \brief GameStateFile::save overwrites the stored record
+ * \param [in] payload a serialized game
+ * \return whether the record was written
+ *
+ * the record is flushed to the OS, so it survives a crash of the application
+ */
+bool GameStateFile::save(const QByteArray &payload)
+{
+    if (!openFile())
+        return false;
+
+    QByteArray record;
+    record.reserve(HEADER_SIZE + payload.size());
+
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << STATE_MAGIC << _version
+        << qChecksum(payload.constData(), uint(payload.size()))
+        << quint32(payload.size());
+    record.append(payload);
+
+    return file.seek(0)
+        && file.write(record) == record.size()
+        && file.resize(record.size())   ///< cut the tail of a longer previous record
+        && file.flush();
+}
+
+/*!
+ * \brief GameStateFile::load reads the stored record
+ * \return the payload or an empty QByteArray if there is no valid record of this version
+ */
+QByteArray GameStateFile::load()
+{
+    if (!openFile() || !file.seek(0))
+        return QByteArray();
+
+    return payloadOf(file.readAll(), _version);
+}
+
+/*!
+ * \brief GameStateFile::clear drops the stored record, f.i. when a game is done
+ */
+void GameStateFile::clear()
+{
+    if (openFile())
+        file.resize(0);
+}
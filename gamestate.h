@@ -0,0 +1,39 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <QFile>
+#include <QDataStream>
+#include <QByteArray>
+#include <QString>
+
+/*!
+ * \brief GameStateFile keeps a binary snapshot of a live game
+ *
+ * a game serializes itself into a payload (see NumPairs, Numem)
+ *      and GameStateFile stores it as one record:
+ *      magic, format version, checksum, payload size and the payload
+ * the file is kept opened and is overwritten in place without fsync,
+ *      so a save on every move costs a single small write
+ * a torn or outdated record fails the checks on load and is ignored
+ *
+ * see gamestate.cpp
+ */
+class GameStateFile
+{
+public:
+    static const int STREAM_VERSION = QDataStream::Qt_5_0;  ///< payloads are to be streamed with this version
+
+    GameStateFile(const QString &name, quint16 version);    ///< see gamestate.cpp
+    static bool hasRecord(const QString &name, quint16 version);    ///< see gamestate.cpp
+
+    bool save(const QByteArray &payload);   ///< see gamestate.cpp
+    QByteArray load();                      ///< see gamestate.cpp
+    void clear();                           ///< see gamestate.cpp
+private:
+    bool openFile();
+
+    QFile file;
+    quint16 _version;   ///< a payload of another version is not loaded
+};
+
+#endif // GAMESTATE_H
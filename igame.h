@@ -3,6 +3,7 @@
 
 #include "Numem.h"
 #include "NumPairs.h"
+#include "arena.h"
 #include <QMainWindow>
 
 /*!
@@ -29,6 +30,22 @@ public:
      * \return QString - the Game's name
      */
     virtual QString getName() const = 0;
+    /*!
+     * \brief windowSize returns a size of the MainWindow to fit the Game
+     * \return QSize - the MainWindow's size, most games fit the default one
+     */
+    virtual QSize windowSize() const
+    {
+        return QSize(270, 400);
+    }
+    /*!
+     * \brief hasSavedGame tells whether the Game was interrupted and can be continued
+     * \return bool - true if playGame() will restore a saved game
+     */
+    virtual bool hasSavedGame() const
+    {
+        return false;
+    }
 public slots:
     /*!
      * \brief playGame responsible for game launching
@@ -42,6 +59,7 @@ public slots:
 
         if (_gameWidget) {
             _gameWidget->setAttribute(Qt::WA_DeleteOnClose);
+            _parent->setFixedSize(windowSize());
             _parent->setCentralWidget(_gameWidget);
         } else {
             //todo: add an error handler
@@ -66,6 +84,10 @@ public:
     {
         return QString("Numem");
     }
+    bool hasSavedGame() const override
+    {
+        return Numem::hasSavedState();
+    }
 protected:
     void createGame(QWidget* &_gameWidget) override
     {
@@ -84,6 +106,10 @@ public:
     {
         return QString("NumPairs");
     }
+    bool hasSavedGame() const override
+    {
+        return NumPairs::hasSavedState();
+    }
 protected:
     void createGame(QWidget* &_gameWidget) override
     {
@@ -92,4 +118,26 @@ protected:
 
 };
 
+class ArenaGame : public IGame
+{
+    Q_OBJECT
+public:
+    ArenaGame(QMainWindow *parent): IGame(parent) {}
+    ~ArenaGame() override {}
+    QString getName() const override
+    {
+        return QString("Arena");
+    }
+    QSize windowSize() const override
+    {
+        return QSize(1180, 800);
+    }
+protected:
+    void createGame(QWidget* &_gameWidget) override
+    {
+        _gameWidget = new Arena(_parent);
+    }
+
+};
+
 #endif // IGAME_H
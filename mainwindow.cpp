@@ -12,16 +12,24 @@
  * all producers are stored in the vector "_game"
  * add a new game producer object in _game initializer {} to add a new game
  *    using a new instruction of memory allocating
+ * if a game was interrupted (see IGame::hasSavedGame()) it's launched at once
  */
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
-    _games = {new NumPairsGame(this), new NumemGame(this)};  ///< games producers: add a new game producer here
+    _games = {new NumPairsGame(this), new NumemGame(this),
+              new ArenaGame(this)};                         ///< games producers: add a new game producer here
     setWindowTitle(QString("Games of Memory"));
     setFixedSize(QSize(270, 400));
 
     createMenuBar();        ///> see createMenuBar() implementation
     totalConnect();         ///> see totalConnect() implementation
+
+    for (auto iter: _games)                 ///> continue an interrupted game at startup
+        if (iter->hasSavedGame()) {
+            iter->playGame();
+            break;
+        }
 }
 
 /*!
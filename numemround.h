@@ -0,0 +1,89 @@
+#ifndef NUMEMROUND_H
+#define NUMEMROUND_H
+
+#include <QString>
+
+/*!
+ * \brief NumemRound is the state machine of a Numem round without any widgets
+ *
+ * Idle --generate()--> Memorizing --hide()--> Input --check()--> Idle
+ * an event in a wrong phase is ignored
+ * the stress harness (see stress/statestress.cpp) drives it directly from many threads
+ */
+class NumemRound
+{
+public:
+    enum Phase {
+        Idle,           ///< nothing is generated
+        Memorizing,     ///< the number is shown
+        Input           ///< the number is hidden, user inputs it
+    };
+
+    NumemRound(): _phase(Idle) {}
+
+    Phase phase() const {return _phase;}
+    bool isGenerated() const {return _phase != Idle;}
+    const QString &number() const {return _number;}
+
+    /*!
+     * \brief starts a round
+     * \param [in] number what to memorize
+     * \return false if a round is already going on
+     */
+    bool generate(const QString &number)
+    {
+        if (_phase != Idle)
+            return false;
+        _number = number;
+        _phase = Memorizing;
+        return true;
+    }
+
+    /*!
+     * \brief the memorizing time is over
+     * \return false if nothing is being memorized
+     */
+    bool hide()
+    {
+        if (_phase != Memorizing)
+            return false;
+        _phase = Input;
+        return true;
+    }
+
+    /*!
+     * \brief finishes a round
+     * \param [in] input user's input of any length
+     * \return number of wrong digits (a missing digit is wrong, extra ones are ignored)
+     *         or -1 if the number is not hidden yet
+     */
+    int check(const QString &input)
+    {
+        if (_phase != Input)
+            return -1;
+
+        int errors = 0;
+        for (int i = 0; i < _number.size(); ++i)
+            if (i >= input.size() || _number[i] != input[i])
+                ++errors;
+
+        _phase = Idle;
+        return errors;
+    }
+
+    /*!
+     * \brief continues a saved round, the number is hidden
+     * \param [in] number what was memorized
+     */
+    void restore(const QString &number)
+    {
+        _number = number;
+        _phase = Input;
+    }
+
+private:
+    Phase _phase;
+    QString _number;
+};
+
+#endif // NUMEMROUND_H
@@ -0,0 +1,102 @@
+#include "pairsboard.h"
+
+/*!
+ * \brief PairsBoard::PairsBoard creates an empty not started board
+ */
+PairsBoard::PairsBoard()
+    : _openedCount(0), _clicks(0), _isOn(false)
+{
+
+}
+
+/*!
+ * \brief PairsBoard::start begins a new game, all the Plates are closed
+ * \param [in] values values of the Plates, each one is to be met twice
+ */
+void PairsBoard::start(const QVector<int> &values)
+{
+    _values = values;
+    _opened.fill(false, values.size());
+    _matched.fill(false, values.size());
+    _openedCount = 0;
+    _clicks = 0;
+    _isOn = !values.isEmpty();
+}
+
+/*!
+ * \brief PairsBoard::restore continues a saved game
+ * \param [in] values values of the Plates
+ * \param [in] opened which Plates are opened
+ * \param [in] matched which Plates are in done Pairs
+ * \param [in] openedCount Plates opened since the last closing of all
+ * \param [in] clicks clicks done
+ * \return false if the state is inconsistent, the board is not changed then
+ */
+bool PairsBoard::restore(const QVector<int> &values, const QVector<bool> &opened,
+                         const QVector<bool> &matched, int openedCount, int clicks)
+{
+    if (values.isEmpty() || opened.size() != values.size() || matched.size() != values.size()
+            || openedCount < 0 || openedCount > 2 || clicks < 0)
+        return false;
+
+    int openedFree = 0;         ///< opened Plates not in done Pairs
+    for (int i = 0; i < values.size(); ++i) {
+        if (matched[i] && !opened[i])
+            return false;
+        if (opened[i] && !matched[i])
+            ++openedFree;
+    }
+    if (openedFree > openedCount || opened.count(false) == 0)
+        return false;
+
+    _values = values;
+    _opened = opened;
+    _matched = matched;
+    _openedCount = openedCount;
+    _clicks = clicks;
+    _isOn = true;
+    return true;
+}
+
+/*!
+ * \brief PairsBoard::activate is a click on a Plate
+ * \param [in] index the Plate's index
+ * \return false if the click is ignored (the game is not on, a wrong index or a done Pair)
+ *
+ * if two Plates have been opened since the last closing
+ *      all the Plates out of done Pairs are closed first
+ * then the Plate is opened (or closed if it is opened)
+ * an opened Plate with the same value as another opened one makes a done Pair
+ * if no closed Plate is left the game is done
+ */
+bool PairsBoard::activate(int index)
+{
+    if (!_isOn || index < 0 || index >= _values.size() || _matched[index])
+        return false;
+
+    ++_clicks;
+
+    if (_openedCount >= 2) {
+        for (int i = 0; i < _values.size(); ++i)
+            if (!_matched[i])
+                _opened[i] = false;
+        _openedCount = 0;
+    }
+
+    _opened[index] = !_opened[index];
+    _openedCount += _opened[index] ? 1 : -1;
+
+    bool isDone = true;
+    for (int i = 0; i < _values.size(); ++i) {
+        if (_opened[index] && i != index && _opened[i] && !_matched[i] && _values[i] == _values[index])
+            _matched[i] = _matched[index] = true;
+
+        if (!_opened[i])
+            isDone = false;
+    }
+
+    if (isDone)
+        _isOn = false;
+
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef PAIRSBOARD_H
+#define PAIRSBOARD_H
+
+#include <QVector>
+
+/*!
+ * \brief PairsBoard is the state machine of a NumPairs game without any widgets
+ *
+ * it keeps values, opened and done (matched) flags of the Plates,
+ *      the number of currently opened Plates and clicks
+ * NumPairs shows its state with Plates, the stress harness
+ *      (see stress/statestress.cpp) drives it directly from many threads,
+ *      so it must not touch anything shared
+ *
+ * see pairsboard.cpp
+ */
+class PairsBoard
+{
+public:
+    PairsBoard();
+
+    void start(const QVector<int> &values);     ///< see pairsboard.cpp
+    bool restore(const QVector<int> &values, const QVector<bool> &opened,
+                 const QVector<bool> &matched, int openedCount, int clicks); ///< see pairsboard.cpp
+    bool activate(int index);                   ///< see pairsboard.cpp
+
+    int size() const {return _values.size();}
+    int value(int index) const {return _values[index];}
+    bool isOpened(int index) const {return _opened[index];}
+    bool isMatched(int index) const {return _matched[index];}
+    int openedCount() const {return _openedCount;}  ///< Plates opened since the last closing of all
+    int clicks() const {return _clicks;}
+    bool isOn() const {return _isOn;}               ///< is started and not done yet
+private:
+    QVector<int> _values;
+    QVector<bool> _opened, _matched;
+    int _openedCount;
+    int _clicks;
+    bool _isOn;
+};
+
+#endif // PAIRSBOARD_H
@@ -0,0 +1,235 @@
+#include "pairsbot.h"
+#include <algorithm>
+#include <ctime>
+
+/*!
+ * \brief PairsBot::PairsBot creates a bot which remembers nothing
+ * \param [in] parent is used to delegate memory management
+ */
+PairsBot::PairsBot(QObject *parent)
+    : QObject(parent), _memorySize(0), _lookahead(1), random(unsigned(std::time(nullptr)))
+{
+
+}
+
+/*!
+ * \brief PairsBot::reset forgets everything and sets a new difficulty
+ * \param [in] memorySize how many Plates the bot can remember
+ * \param [in] lookahead how many turns the bot looks ahead
+ */
+void PairsBot::reset(int memorySize, int lookahead)
+{
+    _memorySize = memorySize;
+    _lookahead = lookahead;
+    order.clear();
+    memory.clear();
+}
+
+/*!
+ * \brief PairsBot::observe remembers opened Plates and forgets done Pairs
+ * \param [in] shot what is seen on the board now
+ */
+void PairsBot::observe(const BoardSnapshot &shot)
+{
+    for (int i = 0; i < shot.values.size(); ++i) {
+        if (shot.matched[i])
+            forget(i);
+        else if (shot.values[i] >= 0)
+            remember(i, shot.values[i]);
+    }
+}
+
+/*!
+ * \brief PairsBot::think chooses a Plate to open and emits moveChosen()
+ * \param [in] shot what is seen on the board now
+ *
+ * a known Pair is taken at once, otherwise the search decides
+ *      whether to open an unknown Plate or a remembered one
+ */
+void PairsBot::think(const BoardSnapshot &shot)
+{
+    observe(shot);
+    memo.clear();
+
+    QHash<int, QList<int>> byValue;     ///< remembered values -> their Plates
+    QList<int> unknown, any;            ///< Plates the bot knows nothing about, all the available Plates
+
+    for (int i = 0; i < shot.values.size(); ++i) {
+        if (shot.matched[i] || i == shot.firstPick)
+            continue;
+        any.append(i);
+        if (memory.contains(i))
+            byValue[memory[i]].append(i);
+        else
+            unknown.append(i);
+    }
+
+    QList<int> singles, pairs;          ///< Plates which partner is unknown, Plates of known Pairs
+    for (auto it = byValue.constBegin(); it != byValue.constEnd(); ++it) {
+        if (shot.firstPick >= 0 && it.key() == shot.values[shot.firstPick])
+            continue;                   ///< the partner of the first Plate is handled separately
+        if (it->size() >= 2)
+            pairs.append(*it);
+        else
+            singles.append(*it);
+    }
+
+    const int unknownCount = unknown.size();
+    const int singlesCount = singles.size();
+    int move = -1;
+
+    if (shot.firstPick < 0) {
+        if (!pairs.isEmpty()) {
+            move = pairs.first();
+        } else if (unknownCount) {
+            const double openUnknown = firstUnknown(unknownCount, singlesCount, _lookahead);
+            const double openSeen = singlesCount ? second(unknownCount, singlesCount - 1, _lookahead) : -1e9;
+
+            move = openUnknown >= openSeen ? pickRandom(unknown) : pickRandom(singles);
+        }
+    } else {
+        const QList<int> partner = byValue.value(shot.values[shot.firstPick]);
+
+        if (!partner.isEmpty()) {
+            move = partner.first();
+        } else if (unknownCount) {
+            const double openUnknown = secondUnknown(unknownCount, singlesCount, _lookahead);
+            const double openSeen = singlesCount ? -value(unknownCount, singlesCount + 1, 0, _lookahead - 1) : -1e9;
+
+            move = openUnknown >= openSeen ? pickRandom(unknown) : pickRandom(singles);
+        }
+    }
+
+    if (move < 0)                       ///< the memory is of no use, just open something
+        move = pickRandom(any);
+
+    emit moveChosen(shot.serial, move);
+}
+
+/*!
+ * \brief PairsBot::value estimates a position at the beginning of a turn
+ * \param [in] unknown how many Plates nobody has seen
+ * \param [in] singles how many seen Plates have an unseen partner
+ * \param [in] pairs how many Pairs are fully seen
+ * \param [in] depth how many turns more to look ahead
+ * \return expected (own Pairs - opponent's Pairs) for the player to move
+ *
+ * the players are supposed to remember everything they see,
+ *      a chance node is a random unknown Plate, a player node is max()
+ *      and a turn passing negates the opponent's value
+ */
+double PairsBot::value(int unknown, int singles, int pairs, int depth)
+{
+    if (pairs > 0)                      ///< a known Pair is taken and the turn goes on
+        return 1 + value(unknown, singles, pairs - 1, depth);
+    if (unknown <= 0 || depth <= 0)
+        return 0;
+
+    const quint64 key = (quint64(unknown) << 32) | (quint64(singles) << 16) | quint64(depth);
+    const auto cached = memo.constFind(key);
+    if (cached != memo.constEnd())
+        return *cached;
+
+    double best = firstUnknown(unknown, singles, depth);
+    if (singles)
+        best = std::max(best, second(unknown, singles - 1, depth));
+
+    memo.insert(key, best);
+    return best;
+}
+
+/*!
+ * \brief PairsBot::firstUnknown estimates opening an unknown Plate first in a turn
+ * \param [in] unknown how many Plates nobody has seen
+ * \param [in] singles how many seen Plates have an unseen partner
+ * \param [in] depth how many turns more to look ahead
+ * \return expected (own Pairs - opponent's Pairs) for the player to move
+ */
+double PairsBot::firstUnknown(int unknown, int singles, int depth)
+{
+    double res = double(std::max(unknown - singles, 0)) / unknown * second(unknown - 1, singles, depth);
+    if (singles)                        ///< the Plate may be a partner of a seen one
+        res += double(singles) / unknown * (1 + value(unknown - 1, singles - 1, 0, depth - 1));
+
+    return res;
+}
+
+/*!
+ * \brief PairsBot::secondUnknown estimates opening an unknown Plate second in a turn
+ * \param [in] unknown how many Plates nobody has seen (the first Plate's partner is among them)
+ * \param [in] singles how many other seen Plates have an unseen partner
+ * \param [in] depth how many turns more to look ahead
+ * \return expected (own Pairs - opponent's Pairs) for the player to move
+ *
+ * if the Plate turns out to be a partner of another seen Plate
+ *      the opponent gets a known Pair
+ */
+double PairsBot::secondUnknown(int unknown, int singles, int depth)
+{
+    double res = 1.0 / unknown * (1 + value(unknown - 1, singles, 0, depth - 1));
+    if (singles)
+        res -= double(singles) / unknown * value(unknown - 1, singles, 1, depth - 1);
+    if (unknown - 1 - singles > 0)
+        res -= double(unknown - 1 - singles) / unknown * value(unknown - 1, singles + 2, 0, depth - 1);
+
+    return res;
+}
+
+/*!
+ * \brief PairsBot::second estimates the second move of a turn
+ * \param [in] unknown how many Plates nobody has seen (the first Plate's partner is among them)
+ * \param [in] singles how many other seen Plates have an unseen partner
+ * \param [in] depth how many turns more to look ahead
+ * \return expected (own Pairs - opponent's Pairs) for the player to move
+ */
+double PairsBot::second(int unknown, int singles, int depth)
+{
+    if (unknown <= 0)
+        return 0;
+
+    double best = secondUnknown(unknown, singles, depth);
+    if (singles)                        ///< opening a seen Plate reveals nothing to the opponent
+        best = std::max(best, -value(unknown, singles + 1, 0, depth - 1));
+
+    return best;
+}
+
+/*!
+ * \brief PairsBot::remember puts an opened Plate into the memory
+ * \param [in] index the Plate's index
+ * \param [in] value the Plate's value
+ *
+ * a Plate seen again becomes the freshest one,
+ *      the oldest Plates are forgotten if the memory is full
+ */
+void PairsBot::remember(int index, int value)
+{
+    order.removeOne(index);
+    order.append(index);
+    memory.insert(index, value);
+
+    while (order.size() > _memorySize)
+        memory.remove(order.takeFirst());
+}
+
+/*!
+ * \brief PairsBot::forget removes a Plate from the memory
+ * \param [in] index the Plate's index
+ */
+void PairsBot::forget(int index)
+{
+    order.removeOne(index);
+    memory.remove(index);
+}
+
+/*!
+ * \brief PairsBot::pickRandom
+ * \param [in] indexes Plates to choose from
+ * \return a random one of indexes or -1 if indexes is empty
+ */
+int PairsBot::pickRandom(const QList<int> &indexes)
+{
+    if (indexes.isEmpty())
+        return -1;
+    return indexes[int(random() % unsigned(indexes.size()))];
+}
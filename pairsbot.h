@@ -0,0 +1,65 @@
+#ifndef PAIRSBOT_H
+#define PAIRSBOT_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <random>
+
+/*!
+ * \brief BoardSnapshot is what a NumPairs player can see on the board
+ *
+ * it is a plain value, so it is safe to pass it to another thread
+ */
+struct BoardSnapshot
+{
+    int serial = 0;         ///< a move request's id, is sent back with the chosen move
+    int firstPick = -1;     ///< index of the Plate opened first in the current turn, -1 if none
+    QVector<int> values;    ///< values of opened Plates, -1 for closed ones
+    QVector<bool> matched;  ///< whether a Plate is already in a done Pair
+};
+
+Q_DECLARE_METATYPE(BoardSnapshot)
+
+/*!
+ * \brief PairsBot is a computer opponent for NumPairs
+ *
+ * it lives in a worker thread and talks to NumPairs through queued signals only
+ * it remembers the last memorySize opened Plates (older ones are forgotten)
+ * and chooses moves with an expectiminimax search over its own knowledge:
+ *      the search looks lookahead turns ahead and takes into account
+ *      what the opponent would get from the Plates the bot reveals
+ *
+ * see pairsbot.cpp
+ */
+class PairsBot : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PairsBot(QObject *parent = nullptr);   ///< see pairsbot.cpp
+public slots:
+    void reset(int memorySize, int lookahead);      ///< see pairsbot.cpp
+    void observe(const BoardSnapshot &shot);        ///< see pairsbot.cpp
+    void think(const BoardSnapshot &shot);          ///< see pairsbot.cpp
+signals:
+    void moveChosen(int serial, int index);         ///< the Plate to open in reply to think()
+private:
+    void remember(int index, int value);
+    void forget(int index);
+    double value(int unknown, int singles, int pairs, int depth);
+    double firstUnknown(int unknown, int singles, int depth);
+    double secondUnknown(int unknown, int singles, int depth);
+    double second(int unknown, int singles, int depth);
+    int pickRandom(const QList<int> &indexes);
+
+    int _memorySize;            ///< how many Plates the bot can remember
+    int _lookahead;             ///< the search depth in turns
+    QList<int> order;           ///< remembered Plates' indexes, the oldest first
+    QHash<int, int> memory;     ///< remembered Plates: index -> value
+    QHash<quint64, double> memo;///< search results for the current think()
+    std::mt19937 random;
+};
+
+#endif // PAIRSBOT_H
@@ -0,0 +1,562 @@
+#include "sessionlog.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QDataStream>
+#include <QByteArray>
+#include <QHash>
+#include <QDir>
+
+const int SessionExporter::BLOCK_ROWS;
+const int SessionExporter::FLUSH_ROWS;
+const int SessionExporter::FLUSH_DELAY;
+
+static const quint32 FILE_MAGIC = 0x4D47434C;   ///< "MGCL"
+static const quint16 FILE_VERSION = 2;          ///< 2: checksums of block headers and columns
+static const quint32 BLOCK_MAGIC = 0x424C4B31;  ///< "BLK1"
+static const int FILE_HEADER_SIZE = 6;          ///< magic and version
+static const int STREAM_VERSION = QDataStream::Qt_5_0;
+static const int SEARCH_CHUNK = 64 * 1024;      ///< bytes read at once while looking for a block
+
+/*!
+ * \brief column encodings
+ */
+enum Encoding : quint8 {
+    DeltaEncoding = 1,      ///< zigzag varints of differences with a previous value
+    DictionaryEncoding = 2, ///< distinct values once, then a varint index per row
+    VarintEncoding = 3      ///< zigzag varints
+};
+
+/*!
+ * \brief an encoded column of a block
+ */
+struct Column
+{
+    quint8 id;          ///< a SessionColumn value
+    quint8 encoding;    ///< an Encoding value
+    QByteArray data;    ///< encoded values, they are compressed on writing
+};
+
+/*!
+ * \brief a block header, the columns follow it one after another
+ */
+struct BlockHeader
+{
+    quint32 rows = 0;
+    qint64 minTs = 0, maxTs = 0;    ///< the time range of the rows
+    QVector<quint8> ids;            ///< SessionColumn values
+    QVector<quint8> encodings;      ///< Encoding values
+    QVector<quint32> sizes;         ///< compressed sizes
+    QVector<quint16> checksums;     ///< qChecksum of the compressed columns
+    qint64 dataSize = 0;            ///< the size of all the columns
+};
+
+static quint64 zigzag(qint64 value)
+{
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+static qint64 unzigzag(quint64 value)
+{
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+/*!
+ * \brief appends a LEB128 varint
+ * \param [out] out where to append
+ * \param [in] value what to append
+ */
+static void appendVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+/*!
+ * \brief reads a LEB128 varint
+ * \param [in] in where to read from
+ * \param [in,out] pos a position in 'in', is moved past the varint
+ * \param [out] value the read value
+ * \return false if 'in' ends in the middle of the varint
+ */
+static bool readVarint(const QByteArray &in, int &pos, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        const quint8 byte = quint8(in[pos++]);
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static QByteArray encodeNumbers(const QVector<qint64> &values, bool delta)
+{
+    QByteArray out;
+    qint64 prev = 0;
+
+    out.reserve(values.size() * 2);
+    for (const auto value: values) {
+        appendVarint(out, zigzag(delta ? value - prev : value));
+        prev = value;
+    }
+    return out;
+}
+
+static bool decodeNumbers(const QByteArray &in, int rows, bool delta, QVector<qint64> &values)
+{
+    int pos = 0;
+    qint64 prev = 0;
+
+    values.resize(rows);
+    for (int i = 0; i < rows; ++i) {
+        quint64 raw = 0;
+        if (!readVarint(in, pos, raw))
+            return false;
+        values[i] = delta ? prev + unzigzag(raw) : unzigzag(raw);
+        prev = values[i];
+    }
+    return true;
+}
+
+static QByteArray encodeDictionary(const QVector<QByteArray> &values)
+{
+    QHash<QByteArray, int> indexes;
+    QVector<QByteArray> dictionary;
+    QByteArray rowsPart;
+
+    for (const auto &value: values) {
+        auto it = indexes.find(value);
+        if (it == indexes.end()) {
+            it = indexes.insert(value, dictionary.size());
+            dictionary.append(value);
+        }
+        appendVarint(rowsPart, quint64(*it));
+    }
+
+    QByteArray out;
+    appendVarint(out, quint64(dictionary.size()));
+    for (const auto &entry: dictionary) {
+        appendVarint(out, quint64(entry.size()));
+        out.append(entry);
+    }
+    return out + rowsPart;
+}
+
+static bool decodeDictionary(const QByteArray &in, int rows, QVector<QByteArray> &values)
+{
+    int pos = 0;
+    quint64 size = 0;
+
+    if (!readVarint(in, pos, size) || size > quint64(in.size()))
+        return false;
+
+    QVector<QByteArray> dictionary;
+    dictionary.reserve(int(size));
+    for (quint64 i = 0; i < size; ++i) {
+        quint64 length = 0;
+        if (!readVarint(in, pos, length) || length > quint64(in.size() - pos))
+            return false;
+        dictionary.append(in.mid(pos, int(length)));
+        pos += int(length);
+    }
+
+    values.resize(rows);
+    for (int i = 0; i < rows; ++i) {
+        quint64 index = 0;
+        if (!readVarint(in, pos, index) || index >= size)
+            return false;
+        values[i] = dictionary[int(index)];
+    }
+    return true;
+}
+
+/*!
+ * \brief reads a block header at the current position of a file
+ * \param [in] file the log file
+ * \param [out] header the read header
+ * \return false if there is no whole block at the position:
+ *      a wrong magic or checksum, too many rows, or the columns run past the end of the file
+ *
+ * the file is left at the first column of the block
+ */
+static bool readBlockHeader(QFile &file, BlockHeader &header)
+{
+    const qint64 start = file.pos();
+    QDataStream in(&file);
+    in.setVersion(STREAM_VERSION);
+    quint32 magic = 0;
+    quint8 count = 0;
+    quint16 checksum = 0;
+
+    in >> magic >> header.rows >> header.minTs >> header.maxTs >> count;
+    if (in.status() != QDataStream::Ok || magic != BLOCK_MAGIC
+            || header.rows > quint32(SessionExporter::BLOCK_ROWS))
+        return false;
+
+    header.ids.resize(count);
+    header.encodings.resize(count);
+    header.sizes.resize(count);
+    header.checksums.resize(count);
+    header.dataSize = 0;
+    for (int i = 0; i < count; ++i) {
+        in >> header.ids[i] >> header.encodings[i] >> header.sizes[i] >> header.checksums[i];
+        header.dataSize += header.sizes[i];
+    }
+    in >> checksum;
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    const qint64 dataStart = file.pos();
+    if (!file.seek(start))
+        return false;
+    const QByteArray raw = file.read(dataStart - start - qint64(sizeof(checksum)));
+    if (qChecksum(raw.constData(), uint(raw.size())) != checksum)
+        return false;
+
+    return file.seek(dataStart) && dataStart + header.dataSize <= file.size();
+}
+
+/*!
+ * \brief looks for the next block after a torn or damaged one
+ * \param [in] file the log file
+ * \param [in] from where to start looking
+ * \return the position of the next BLOCK_MAGIC or -1 if there is none
+ *
+ * the file is read by SEARCH_CHUNK bytes,
+ *      the magic may be met inside compressed data too, readBlockHeader() rejects such a position
+ */
+static qint64 findBlockMagic(QFile &file, qint64 from)
+{
+    QByteArray magic;
+    QDataStream out(&magic, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    out << BLOCK_MAGIC;
+
+    while (file.seek(from)) {
+        const QByteArray chunk = file.read(SEARCH_CHUNK);
+        const int index = chunk.indexOf(magic);
+        if (index >= 0)
+            return from + index;
+        if (chunk.size() < SEARCH_CHUNK)
+            return -1;
+        from += chunk.size() - (magic.size() - 1);  ///< the magic may be split between chunks
+    }
+    return -1;
+}
+
+/*!
+ * \brief measures the part of a log file new blocks can follow
+ * \param [in] file the log file
+ * \return the offset after the last whole block (after the file header if there is none),
+ *      damaged blocks before it are skipped as the reader does,
+ *      0 if even the file header is torn,
+ *      -1 if the file is a log of another format
+ */
+static qint64 validSize(QFile &file)
+{
+    if (file.size() < FILE_HEADER_SIZE || !file.seek(0))
+        return 0;
+
+    QDataStream in(&file);
+    in.setVersion(STREAM_VERSION);
+    quint32 magic = 0;
+    quint16 version = 0;
+
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FILE_VERSION)
+        return -1;
+
+    qint64 end = FILE_HEADER_SIZE;
+    qint64 pos = end;
+    BlockHeader header;
+    while (pos >= 0 && pos < file.size()) {
+        if (file.seek(pos) && readBlockHeader(file, header))
+            end = pos = file.pos() + header.dataSize;
+        else                                        ///< a damaged block, whole ones may follow it
+            pos = findBlockMagic(file, pos + 1);
+    }
+    return end;
+}
+
+/*!
+ * \brief SessionExporter::instance gives the exporter all the games write to
+ * \return the exporter of sessions.mgcl in the application's data directory
+ *
+ * the exporter is destroyed (and its last rows are written) at the exit
+ */
+SessionExporter *SessionExporter::instance()
+{
+    static SessionExporter exporter([]() {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dir);
+        return dir + "/sessions.mgcl";
+    }());
+    return &exporter;
+}
+
+/*!
+ * \brief SessionExporter::SessionExporter prepares appending to a file, nothing is written yet
+ * \param [in] path the log file
+ *
+ * the buffered rows are written at QCoreApplication::aboutToQuit if there is an application
+ */
+SessionExporter::SessionExporter(const QString &path)
+    : file(path)
+{
+    rows.reserve(FLUSH_ROWS);
+
+    if (QCoreApplication *app = QCoreApplication::instance())
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() { flush(); });
+}
+
+/*!
+ * \brief SessionExporter::append adds a round to the current block
+ * \param [in] record the round
+ *
+ * the block is written when FLUSH_ROWS are collected,
+ *      the first row of a block schedules its writing in FLUSH_DELAY
+ * while the file can't be written rows are kept up to BLOCK_ROWS, then the oldest ones are dropped
+ */
+void SessionExporter::append(const SessionRecord &record)
+{
+    if (rows.size() >= BLOCK_ROWS)
+        rows.removeFirst();
+    rows.append(record);
+    if (rows.size() >= FLUSH_ROWS)
+        flush();
+    else if (rows.size() == 1 && QCoreApplication::instance())
+        QTimer::singleShot(FLUSH_DELAY, QCoreApplication::instance(), [this]() { flush(); });
+}
+
+/*!
+ * \brief SessionExporter::openFile opens the file once, then it stays opened
+ * \return whether the file is opened
+ *
+ * a torn block at the end (the application has crashed while writing) is cut off,
+ *      so the new blocks follow the last whole one,
+ *      a file of another format is kept aside as (path).old and a new one is started
+ */
+bool SessionExporter::openFile()
+{
+    if (file.isOpen())
+        return true;
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    const qint64 size = validSize(file);
+    if (size < 0) {
+        const QString path = file.fileName();
+        QFile::remove(path + ".old");
+        if (!file.rename(path + ".old"))
+            return false;
+        file.setFileName(path);
+        if (!file.open(QIODevice::ReadWrite))
+            return false;
+    }
+
+    return file.resize(qMax(size, qint64(0))) && file.seek(file.size());
+}
+
+/*!
+ * \brief SessionExporter::flush writes the collected rows as a block
+ * \return whether the block is written
+ *
+ * a block failed to be written whole is cut off the file,
+ *      its rows stay buffered for the next flush
+ */
+bool SessionExporter::flush()
+{
+    if (rows.isEmpty())
+        return true;
+    if (!openFile())
+        return false;
+
+    QVector<qint64> timestamps, clicks, elapsed, errors, lengths;
+    QVector<QByteArray> games, difficultyKeys, opponents;
+    qint64 minTs = rows.first().timestamp, maxTs = minTs;
+
+    for (const auto &row: rows) {
+        timestamps.append(row.timestamp);
+        games.append(row.game.toUtf8());
+        difficultyKeys.append(QByteArray::number(row.difficulty));
+        opponents.append(row.opponent.toUtf8());
+        clicks.append(row.clicks);
+        elapsed.append(row.elapsed);
+        errors.append(row.errors);
+        lengths.append(row.length);
+        minTs = qMin(minTs, row.timestamp);
+        maxTs = qMax(maxTs, row.timestamp);
+    }
+
+    const QVector<Column> columns = {
+        {TimestampColumn, DeltaEncoding, encodeNumbers(timestamps, true)},
+        {GameColumn, DictionaryEncoding, encodeDictionary(games)},
+        {DifficultyColumn, DictionaryEncoding, encodeDictionary(difficultyKeys)},
+        {ClicksColumn, VarintEncoding, encodeNumbers(clicks, false)},
+        {ElapsedColumn, VarintEncoding, encodeNumbers(elapsed, false)},
+        {ErrorsColumn, VarintEncoding, encodeNumbers(errors, false)},
+        {LengthColumn, VarintEncoding, encodeNumbers(lengths, false)},
+        {OpponentColumn, DictionaryEncoding, encodeDictionary(opponents)},
+    };
+
+    QByteArray fileHeader, header;
+    QDataStream fileOut(&fileHeader, QIODevice::WriteOnly);
+    QDataStream out(&header, QIODevice::WriteOnly);
+    QVector<QByteArray> compressed;
+
+    fileOut.setVersion(STREAM_VERSION);
+    out.setVersion(STREAM_VERSION);
+
+    if (file.size() == 0)           ///< a new file starts with its header
+        fileOut << FILE_MAGIC << FILE_VERSION;
+
+    out << BLOCK_MAGIC << quint32(rows.size()) << minTs << maxTs << quint8(columns.size());
+    for (const auto &column: columns) {
+        compressed.append(qCompress(column.data));
+        out << column.id << column.encoding << quint32(compressed.last().size())
+            << qChecksum(compressed.last().constData(), uint(compressed.last().size()));
+    }
+    out << qChecksum(header.constData(), uint(header.size()));
+
+    QByteArray block = fileHeader + header;
+    for (const auto &data: compressed)
+        block.append(data);
+
+    const qint64 end = file.size();
+    if (file.write(block) == block.size() && file.flush()) {
+        rows.clear();
+        return true;
+    }
+
+    file.resize(end);
+    file.seek(end);
+    return false;
+}
+
+SessionExporter::~SessionExporter()
+{
+    flush();
+}
+
+/*!
+ * \brief SessionReader::SessionReader
+ * \param [in] path the log file
+ */
+SessionReader::SessionReader(const QString &path)
+    : file(path)
+{
+
+}
+
+/*!
+ * \brief SessionReader::scan passes rounds of a time range to a callback
+ * \param [in] callback is called for every round found, block by block
+ * \param [in] columns a mask of SessionColumn, only these fields are filled
+ * \param [in] from the first timestamp to pass
+ * \param [in] to the last timestamp to pass
+ * \return false if the file can't be read or is not a log of this version
+ *
+ * a block entirely out of [from, to] and columns not in the mask are skipped
+ *      without reading and decompressing, memory is bounded by one block
+ * a block with a damaged header is skipped up to the next BLOCK_MAGIC,
+ *      a block with a damaged column is skipped whole
+ */
+bool SessionReader::scan(const std::function<void(const SessionRecord &)> &callback,
+                         int columns, qint64 from, qint64 to)
+{
+    if (!file.isOpen() && !file.open(QIODevice::ReadOnly))
+        return false;
+    if (!file.seek(0))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(STREAM_VERSION);
+    quint32 magic = 0;
+    quint16 version = 0;
+
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC || version != FILE_VERSION)
+        return false;
+
+    qint64 pos = file.pos();
+    BlockHeader header;
+
+    while (pos < file.size()) {
+        if (!file.seek(pos) || !readBlockHeader(file, header)) {
+            pos = findBlockMagic(file, pos + 1);
+            if (pos < 0)
+                break;
+            continue;
+        }
+
+        const qint64 dataStart = file.pos();
+        pos = dataStart + header.dataSize;          ///< the next block
+
+        if (header.maxTs < from || header.minTs > to)   ///< the whole block is out of the range
+            continue;
+
+        const int rows = int(header.rows);
+        const bool isPartial = header.minTs < from || header.maxTs > to;
+        const int needed = columns | (isPartial ? int(TimestampColumn) : 0);
+        QVector<SessionRecord> block(rows);
+        qint64 columnStart = dataStart;
+        bool isOk = true;
+
+        for (int i = 0; i < header.ids.size(); columnStart += header.sizes[i++]) {
+            const quint8 id = header.ids[i];
+            if (!(id & needed))                     ///< not asked for, not decompressed
+                continue;
+
+            const bool isDictionary = id == GameColumn || id == DifficultyColumn || id == OpponentColumn;
+            if (isDictionary != (header.encodings[i] == DictionaryEncoding) || !file.seek(columnStart)) {
+                isOk = false;
+                break;
+            }
+
+            const QByteArray raw = file.read(header.sizes[i]);
+            if (raw.size() != int(header.sizes[i])
+                    || qChecksum(raw.constData(), uint(raw.size())) != header.checksums[i]) {
+                isOk = false;
+                break;
+            }
+
+            const QByteArray data = qUncompress(raw);
+            QVector<qint64> numbers;
+            QVector<QByteArray> keys;
+            isOk = isDictionary
+                    ? decodeDictionary(data, rows, keys)
+                    : decodeNumbers(data, rows, header.encodings[i] == DeltaEncoding, numbers);
+            if (!isOk)
+                break;
+
+            for (int row = 0; row < rows; ++row) {
+                SessionRecord &record = block[row];
+                switch (id) {
+                case TimestampColumn:  record.timestamp = numbers[row]; break;
+                case GameColumn:       record.game = QString::fromUtf8(keys[row]); break;
+                case DifficultyColumn: record.difficulty = keys[row].toInt(); break;
+                case ClicksColumn:     record.clicks = qint32(numbers[row]); break;
+                case ElapsedColumn:    record.elapsed = numbers[row]; break;
+                case ErrorsColumn:     record.errors = qint32(numbers[row]); break;
+                case LengthColumn:     record.length = qint32(numbers[row]); break;
+                case OpponentColumn:   record.opponent = QString::fromUtf8(keys[row]); break;
+                default: break;                     ///< a column of a newer writer
+                }
+            }
+        }
+
+        if (!isOk)                                  ///< a damaged block, its rows are not passed
+            continue;
+
+        for (const auto &record: block)
+            if (!isPartial || (record.timestamp >= from && record.timestamp <= to))
+                callback(record);
+    }
+
+    return true;
+}
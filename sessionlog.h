@@ -0,0 +1,105 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <limits>
+
+/*!
+ * \file sessionlog.h
+ * \brief a columnar compressed log of finished rounds for offline analysis
+ *
+ * a file is a header ("MGCL", version) followed by independent blocks
+ * a block keeps up to SessionExporter::BLOCK_ROWS rows column by column:
+ *      a block header (rows, time range, per column: id, encoding, size, checksum,
+ *      and a checksum of the header) is followed by the columns,
+ *      each one is encoded and zlib compressed
+ * encodings: timestamps are delta coded, game, difficulty and opponent are dictionary coded,
+ *      the other columns are zigzag varints
+ * a reader skips blocks out of a time range and columns it's not asked for
+ *      without decompressing them, and damaged blocks up to the next block magic
+ * a writer cuts a torn block off the end of the file before appending
+ */
+
+/*!
+ * \brief SessionRecord is a finished round
+ *
+ * a column not related to the game is 0
+ */
+struct SessionRecord
+{
+    qint64 timestamp = 0;   ///< when the round was finished, mlsecs since the epoch
+    QString game;           ///< IGame::getName() of the game
+    qint32 difficulty = 0;  ///< the difficulty of the played board or number
+    QString opponent;       ///< NumPairs: "solo" or the cpu opponent's level
+    qint32 clicks = 0;      ///< NumPairs: clicks on Plates, the opponent's ones included
+    qint64 elapsed = 0;     ///< NumPairs: mlsecs to open all the Plates
+    qint32 errors = 0;      ///< Numem: wrong digits
+    qint32 length = 0;      ///< Numem: digits to remember
+};
+
+/*!
+ * \brief columns of a SessionRecord, are used as a mask to choose what to read
+ */
+enum SessionColumn {
+    TimestampColumn  = 0x01,
+    GameColumn       = 0x02,
+    DifficultyColumn = 0x04,
+    ClicksColumn     = 0x08,
+    ElapsedColumn    = 0x10,
+    ErrorsColumn     = 0x20,
+    LengthColumn     = 0x40,
+    OpponentColumn   = 0x80,
+    AllColumns       = 0xFF
+};
+
+/*!
+ * \brief SessionExporter appends finished rounds to a session log file
+ *
+ * rows are buffered and written as a block when FLUSH_ROWS are collected,
+ *      FLUSH_DELAY after the first buffered row, at QCoreApplication::aboutToQuit
+ *      or when the exporter is destroyed, so a crash loses a few recent rounds at most
+ *
+ * see sessionlog.cpp
+ */
+class SessionExporter
+{
+public:
+    static const int BLOCK_ROWS = 1024;     ///< the most rows in a block
+    static const int FLUSH_ROWS = 16;       ///< a block is written when so many rows are buffered
+    static const int FLUSH_DELAY = 10000;   ///< mlsecs a row may wait in the buffer
+
+    static SessionExporter *instance();     ///< see sessionlog.cpp
+    explicit SessionExporter(const QString &path);
+    ~SessionExporter();
+
+    void append(const SessionRecord &record);   ///< see sessionlog.cpp
+    bool flush();                               ///< see sessionlog.cpp
+private:
+    bool openFile();
+
+    QFile file;
+    QVector<SessionRecord> rows;                ///< the block being collected
+};
+
+/*!
+ * \brief SessionReader scans a session log file
+ *
+ * see sessionlog.cpp
+ */
+class SessionReader
+{
+public:
+    explicit SessionReader(const QString &path);
+
+    bool scan(const std::function<void(const SessionRecord &)> &callback,
+              int columns = AllColumns,
+              qint64 from = std::numeric_limits<qint64>::min(),
+              qint64 to = std::numeric_limits<qint64>::max());  ///< see sessionlog.cpp
+private:
+    QFile file;
+};
+
+#endif // SESSIONLOG_H
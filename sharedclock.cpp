@@ -0,0 +1,64 @@
+#include "sharedclock.h"
+#include <QCoreApplication>
+
+const int SharedClock::INTERVAL;
+
+/*!
+ * \brief SharedClock::SharedClock prepares a stopped timer
+ * \param [in] parent is used to delegate memory management
+ */
+SharedClock::SharedClock(QObject *parent)
+    : QObject(parent)
+{
+    clock.start();
+    timer.setInterval(INTERVAL);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(timeout()));
+}
+
+/*!
+ * \brief SharedClock::instance gives the clock shared by all the games
+ * \return the clock, it is owned by the application object
+ */
+SharedClock *SharedClock::instance()
+{
+    static SharedClock *sharedClock = new SharedClock(QCoreApplication::instance());
+    return sharedClock;
+}
+
+/*!
+ * \brief SharedClock::subscribe connects tick() to a slot and starts the timer if it's stopped
+ * \param [in] receiver an object to notify
+ * \param [in] member its slot, as SLOT(name())
+ *
+ * a subscription is unique, subscribing twice is harmless
+ */
+void SharedClock::subscribe(QObject *receiver, const char *member)
+{
+    connect(this, SIGNAL(tick()), receiver, member, Qt::UniqueConnection);
+    if (!timer.isActive())
+        timer.start();
+}
+
+/*!
+ * \brief SharedClock::unsubscribe disconnects tick() from a slot
+ * \param [in] receiver a notified object
+ * \param [in] member its slot, as SLOT(name())
+ *
+ * a destroyed receiver is unsubscribed by Qt itself
+ */
+void SharedClock::unsubscribe(QObject *receiver, const char *member)
+{
+    disconnect(this, SIGNAL(tick()), receiver, member);
+}
+
+/*!
+ * \brief SharedClock::timeout notifies subscribers, stops the timer if there are none
+ */
+void SharedClock::timeout()
+{
+    if (!receivers(SIGNAL(tick()))) {
+        timer.stop();
+        return;
+    }
+    emit tick();
+}
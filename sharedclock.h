@@ -0,0 +1,39 @@
+#ifndef SHAREDCLOCK_H
+#define SHAREDCLOCK_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/*!
+ * \brief SharedClock is one timer for all the games
+ *
+ * instead of a QTimer per widget the games subscribe to tick(),
+ *      so dozens of boards (see Arena) cost one timer event per INTERVAL
+ * the timer runs only while somebody is subscribed
+ *
+ * see sharedclock.cpp
+ */
+class SharedClock : public QObject
+{
+    Q_OBJECT
+public:
+    static const int INTERVAL = 100;    ///< mlsecs between ticks
+
+    static SharedClock *instance();     ///< see sharedclock.cpp
+
+    void subscribe(QObject *receiver, const char *member);      ///< see sharedclock.cpp
+    void unsubscribe(QObject *receiver, const char *member);    ///< see sharedclock.cpp
+    qint64 now() const {return clock.elapsed();}                ///< monotonic mlsecs, is used for deadlines
+signals:
+    void tick();
+private slots:
+    void timeout();
+private:
+    explicit SharedClock(QObject *parent = nullptr);
+
+    QTimer timer;
+    QElapsedTimer clock;
+};
+
+#endif // SHAREDCLOCK_H
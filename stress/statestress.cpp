@@ -0,0 +1,296 @@
+/*!
+ * \file statestress.cpp
+ * \brief a headless stress harness and throughput benchmark of the games' state machines
+ *
+ * every thread drives its own PairsBoard and NumemRound with random events
+ *      (valid and invalid ones: wrong indexes, clicks on done Pairs, events in wrong phases)
+ *      and checks invariants after every step
+ * at the end events per second are reported, the exit code is 1 if an invariant is broken
+ *
+ * usage: statestress [seconds = 3] [threads = all cores] [seed = time]
+ * build: it needs QtCore only, f.i.
+ *      g++ -O2 -fPIC -I.. statestress.cpp ../pairsboard.cpp $(pkg-config --cflags --libs Qt5Core) -lpthread
+ */
+#include "pairsboard.h"
+#include "numemround.h"
+#include <QVector>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int COLUMN_COUNT = 4;      ///< as in NumPairs
+static const int MAX_DIFFICULTY = 5;    ///< as in NumPairs
+static const int MAX_DIGITS = 10;       ///< as in Numem
+static const int CHUNK = 4096;          ///< events between checks of the stop flag
+
+static std::atomic<bool> stopFlag(false);
+static std::mutex failureMutex;
+static std::string failure;             ///< the first broken invariant
+
+/*!
+ * \brief stops all the threads and remembers what is broken
+ * \param [in] what a description of the broken invariant
+ */
+static void fail(const std::string &what)
+{
+    std::lock_guard<std::mutex> locker(failureMutex);
+    if (failure.empty())
+        failure = what;
+    stopFlag = true;
+}
+
+/*!
+ * \brief PairsDriver plays random NumPairs games
+ */
+class PairsDriver
+{
+public:
+    explicit PairsDriver(std::mt19937 &random): random(random), accepted(0) {}
+
+    /*!
+     * \brief makes one random event and checks the board
+     * \return false if an invariant is broken
+     */
+    bool step()
+    {
+        if (!board.isOn() || random() % 64 == 0)    ///< a done game or a restart
+            return start();
+
+        const int index = int(random() % unsigned(board.size() + 2)) - 1;  ///< -1 and size() are wrong ones
+        const bool isExpected = index >= 0 && index < board.size() && !board.isMatched(index);
+
+        if (board.activate(index) != isExpected)
+            return broken("activate() accepted a wrong click or ignored a right one");
+        if (isExpected)
+            ++accepted;
+
+        return check();
+    }
+private:
+    bool start()
+    {
+        const int size = int(random() % MAX_DIFFICULTY + 1) * COLUMN_COUNT;
+        QVector<int> values;
+
+        values.reserve(size);
+        for (int i = 0; i < size; ++i)
+            values.append(i / 2);
+        std::shuffle(values.begin(), values.end(), random);
+
+        partner.fill(-1, size);
+        for (int i = 0; i < size; ++i)
+            for (int j = 0; j < size; ++j)
+                if (i != j && values[i] == values[j])
+                    partner[i] = j;
+
+        board.start(values);
+        accepted = 0;
+        return check();
+    }
+
+    bool check()
+    {
+        int openedFree = 0;
+        bool hasClosed = false;
+
+        if (board.openedCount() < 0 || board.openedCount() > 2)
+            return broken("openedCount is out of [0, 2]");
+
+        for (int i = 0; i < board.size(); ++i) {
+            if (board.isMatched(i) && !board.isOpened(i))
+                return broken("a Plate of a done Pair is closed");
+            if (board.isMatched(i) != board.isMatched(partner[i]))
+                return broken("a done Pair is of one Plate");
+            if (board.isOpened(i) && !board.isMatched(i)) {
+                ++openedFree;
+                if (board.isOpened(partner[i]) && !board.isMatched(partner[i]))
+                    return broken("two opened Plates with the same value are not a done Pair");
+            }
+            if (!board.isOpened(i))
+                hasClosed = true;
+        }
+
+        if (openedFree > 2 || openedFree > board.openedCount())
+            return broken("more than two Plates out of done Pairs are opened");
+        if (board.isOn() != hasClosed)
+            return broken("isOn() doesn't match closed Plates");
+        if (board.clicks() != accepted)
+            return broken("clicks() doesn't match accepted clicks");
+        return true;
+    }
+
+    bool broken(const char *what)
+    {
+        fail(std::string("PairsBoard: ") + what);
+        return false;
+    }
+
+    std::mt19937 &random;
+    PairsBoard board;
+    QVector<int> partner;   ///< index of the Plate with the same value
+    int accepted;           ///< clicks the board must have counted
+};
+
+/*!
+ * \brief NumemDriver plays random Numem rounds, inputs are of any length
+ */
+class NumemDriver
+{
+public:
+    explicit NumemDriver(std::mt19937 &random): random(random), phase(NumemRound::Idle) {}
+
+    /*!
+     * \brief makes one random event and checks the round
+     * \return false if an invariant is broken
+     */
+    bool step()
+    {
+        switch (random() % 4) {
+        case 0: {
+            const QString number = digits(int(random() % (MAX_DIGITS + 1)));
+            const bool isExpected = phase == NumemRound::Idle;
+            if (round.generate(number) != isExpected)
+                return broken("generate() in a wrong phase");
+            if (isExpected) {
+                phase = NumemRound::Memorizing;
+                if (round.number() != number)
+                    return broken("generate() lost the number");
+            }
+            break;
+        }
+        case 1: {
+            const bool isExpected = phase == NumemRound::Memorizing;
+            if (round.hide() != isExpected)
+                return broken("hide() in a wrong phase");
+            if (isExpected)
+                phase = NumemRound::Input;
+            break;
+        }
+        default: {
+            const QString input = digits(int(random() % (MAX_DIGITS + 3)));
+            const QString number = round.number();
+            const int errors = round.check(input);
+
+            if (phase != NumemRound::Input) {
+                if (errors != -1)
+                    return broken("check() in a wrong phase");
+                break;
+            }
+
+            int expected = 0;
+            for (int i = 0; i < number.size(); ++i)
+                if (i >= input.size() || number.at(i) != input.at(i))
+                    ++expected;
+            if (errors != expected || errors < 0 || errors > number.size())
+                return broken("check() counted errors wrong");
+            phase = NumemRound::Idle;
+            break;
+        }
+        }
+
+        if (round.phase() != phase)
+            return broken("the phase is wrong");
+        return true;
+    }
+private:
+    QString digits(int size)
+    {
+        QString res;
+        res.reserve(size);
+        for (int i = 0; i < size; ++i)
+            res.append(QChar('0' + int(random() % 10)));
+        return res;
+    }
+
+    bool broken(const char *what)
+    {
+        fail(std::string("NumemRound: ") + what);
+        return false;
+    }
+
+    std::mt19937 &random;
+    NumemRound round;
+    NumemRound::Phase phase;    ///< the phase the round must be in
+};
+
+/*!
+ * \brief a thread's work: drives both state machines until the stop flag
+ * \param [in] seed the thread's random seed
+ * \param [out] pairsEvents events sent to PairsBoard
+ * \param [out] numemEvents events sent to NumemRound
+ *
+ * the counters are kept local and written once at the exit,
+ *      so the threads don't share cache lines of the adjacent result slots
+ */
+static void worker(unsigned seed, quint64 *pairsEvents, quint64 *numemEvents)
+{
+    std::mt19937 random(seed);
+    PairsDriver pairs(random);
+    NumemDriver numem(random);
+    quint64 events = 0;
+    bool isOk = true;
+
+    while (isOk && !stopFlag.load(std::memory_order_relaxed)) {
+        for (int i = 0; isOk && i < CHUNK; ++i)
+            isOk = pairs.step() && numem.step();
+        if (isOk)
+            events += CHUNK;
+    }
+
+    *pairsEvents = events;
+    *numemEvents = events;
+}
+
+int main(int argc, char *argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    const unsigned threadsCount = std::max(1u, argc > 2 ? unsigned(std::atoi(argv[2]))
+                                                        : std::thread::hardware_concurrency());
+    const unsigned seed = argc > 3 ? unsigned(std::strtoul(argv[3], nullptr, 10)) : unsigned(std::time(nullptr));
+
+    std::printf("statestress: %.1f s, %u threads, seed %u\n", seconds, threadsCount, seed);
+
+    std::vector<std::thread> threads;
+    std::vector<quint64> pairsEvents(threadsCount, 0), numemEvents(threadsCount, 0);
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < threadsCount; ++i)
+        threads.emplace_back(worker, seed + i, &pairsEvents[i], &numemEvents[i]);
+
+    while (!stopFlag && std::chrono::steady_clock::now() - begin < std::chrono::duration<double>(seconds))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    stopFlag = true;
+
+    for (auto &thread: threads)
+        thread.join();
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    quint64 pairsTotal = 0, numemTotal = 0;
+    for (unsigned i = 0; i < threadsCount; ++i) {
+        pairsTotal += pairsEvents[i];
+        numemTotal += numemEvents[i];
+    }
+
+    std::printf("PairsBoard: %llu events, %.0f events/s\n",
+                static_cast<unsigned long long>(pairsTotal), pairsTotal / elapsed);
+    std::printf("NumemRound: %llu events, %.0f events/s\n",
+                static_cast<unsigned long long>(numemTotal), numemTotal / elapsed);
+    std::printf("total: %.0f events/s, %.0f events/s per thread\n",
+                (pairsTotal + numemTotal) / elapsed, (pairsTotal + numemTotal) / elapsed / threadsCount);
+
+    if (!failure.empty()) {
+        std::printf("FAILED: %s (seed %u)\n", failure.c_str(), seed);
+        return 1;
+    }
+    std::printf("all invariants hold\n");
+    return 0;
+}
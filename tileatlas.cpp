@@ -0,0 +1,193 @@
+#include "tileatlas.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QImageReader>
+#include <QRunnable>
+#include <QPainter>
+#include <QBuffer>
+#include <QFile>
+
+const int TileAtlas::TILE_SIDE;
+const int TileAtlas::PAGE_SIDE;
+
+static const int CELLS_PER_ROW = TileAtlas::PAGE_SIDE / TileAtlas::TILE_SIDE;  ///< tiles in a row of a page
+static const int CELLS_PER_PAGE = CELLS_PER_ROW * CELLS_PER_ROW;                ///< tiles in a page
+
+/*!
+ * \brief TileDecoder reads, hashes and decodes one image file in a pool's thread
+ *
+ * the result is posted back to the atlas through a queued call,
+ *      so all the atlas' containers are touched only in the UI thread
+ */
+class TileDecoder : public QRunnable
+{
+public:
+    TileDecoder(TileAtlas *atlas, const QString &path): _atlas(atlas), _path(path) {}
+
+    void run() override
+    {
+        QImage tile;
+        QByteArray hash;
+        QFile file(_path);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            QBuffer buffer;
+            buffer.setData(file.readAll());
+            hash = QCryptographicHash::hash(buffer.data(), QCryptographicHash::Sha1);
+
+            if (_atlas->claim(hash)) {                  ///< the same content may be decoded only once
+                QImageReader reader(&buffer);
+                QSize size = reader.size();
+                if (size.isValid()) {                   ///< downscale while decoding if the format lets it
+                    size.scale(TileAtlas::TILE_SIDE, TileAtlas::TILE_SIDE, Qt::KeepAspectRatio);
+                    reader.setScaledSize(size);
+                }
+                tile = reader.read();
+                if (!tile.isNull() && (tile.width() > TileAtlas::TILE_SIDE || tile.height() > TileAtlas::TILE_SIDE))
+                    tile = tile.scaled(TileAtlas::TILE_SIDE, TileAtlas::TILE_SIDE,
+                                       Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                if (!tile.isNull())
+                    tile = tile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            }
+        }
+
+        QMetaObject::invokeMethod(_atlas, "tileDecoded", Qt::QueuedConnection,
+                                  Q_ARG(QString, _path), Q_ARG(QByteArray, hash), Q_ARG(QImage, tile));
+    }
+private:
+    TileAtlas *_atlas;
+    QString _path;
+};
+
+/*!
+ * \brief TileAtlas::TileAtlas initializes an empty atlas
+ * \param [in] parent is used to delegate memory management
+ */
+TileAtlas::TileAtlas(QObject *parent)
+    : QObject(parent), cellsUsed(CELLS_PER_PAGE)
+{
+
+}
+
+/*!
+ * \brief TileAtlas::instance gives the atlas shared by all the games
+ * \return the atlas, it is owned by the application object
+ */
+TileAtlas *TileAtlas::instance()
+{
+    static TileAtlas *atlas = new TileAtlas(QCoreApplication::instance());
+    return atlas;
+}
+
+/*!
+ * \brief TileAtlas::request starts decoding of an image file if it has not been started yet
+ * \param [in] path a path to the image file
+ *
+ * never blocks, tileReady(path) is emitted when the tile can be drawn
+ */
+void TileAtlas::request(const QString &path)
+{
+    if (requested.contains(path))
+        return;
+
+    requested.insert(path);
+    pool.start(new TileDecoder(this, path));    ///< the pool takes ownership of the decoder
+}
+
+/*!
+ * \brief TileAtlas::isReady
+ * \param [in] path a path to the image file
+ * \return whether the file's tile is packed and can be drawn
+ */
+bool TileAtlas::isReady(const QString &path) const
+{
+    return packed.contains(hashes.value(path));
+}
+
+/*!
+ * \brief TileAtlas::draw paints the tile centered in the target
+ * \param [in] painter a painter of the widget to draw on
+ * \param [in] target where to draw
+ * \param [in] path a path to the image file, nothing is drawn if the tile is not ready
+ */
+void TileAtlas::draw(QPainter *painter, const QRect &target, const QString &path) const
+{
+    const auto it = packed.constFind(hashes.value(path));
+    if (it == packed.constEnd())
+        return;
+
+    QRect place(QPoint(0, 0), it->rect.size());
+    place.moveCenter(target.center());
+    painter->drawPixmap(place, pages[it->page], it->rect);
+}
+
+/*!
+ * \brief TileAtlas::claim is called by a decoder before decoding a content
+ * \param [in] hash the content's hash
+ * \return true if nobody has claimed the content before, so the caller is to decode it
+ *
+ * it is thread safe
+ */
+bool TileAtlas::claim(const QByteArray &hash)
+{
+    QMutexLocker locker(&claimedMutex);
+
+    if (claimed.contains(hash))
+        return false;
+    claimed.insert(hash);
+    return true;
+}
+
+/*!
+ * \brief TileAtlas::tileDecoded packs a decoded tile into the atlas
+ * \param [in] path the decoded file's path
+ * \param [in] hash the file's content hash (empty if the file could not be read)
+ * \param [in] tile a downscaled image (null if the content was claimed by another decoder or is broken)
+ *
+ * is called in the UI thread through a queued connection
+ * emits tileReady() for every path with such a content
+ */
+void TileAtlas::tileDecoded(const QString &path, const QByteArray &hash, const QImage &tile)
+{
+    if (hash.isEmpty())             ///< unreadable file, Plates keep showing numbers
+        return;
+
+    hashes.insert(path, hash);
+    waiting.insert(hash, path);
+
+    if (!tile.isNull() && !packed.contains(hash)) {
+        if (cellsUsed == CELLS_PER_PAGE) {          ///< the last page is full, start a new one
+            QPixmap page(PAGE_SIDE, PAGE_SIDE);
+            page.fill(Qt::transparent);
+            pages.append(page);
+            cellsUsed = 0;
+        }
+
+        const QPoint cell((cellsUsed % CELLS_PER_ROW) * TILE_SIDE, (cellsUsed / CELLS_PER_ROW) * TILE_SIDE);
+        QPainter painter(&pages.last());
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(cell, tile);
+
+        packed.insert(hash, Slot{pages.size() - 1, QRect(cell, tile.size())});
+        ++cellsUsed;
+    }
+
+    if (packed.contains(hash)) {
+        const QStringList ready = waiting.values(hash);
+        waiting.remove(hash);
+        for (const auto &readyPath: ready)
+            emit tileReady(readyPath);
+    }
+}
+
+/*!
+ * \brief TileAtlas::~TileAtlas waits for running decoders
+ *
+ * they post their results to the atlas, so it must outlive them
+ */
+TileAtlas::~TileAtlas()
+{
+    pool.clear();
+    pool.waitForDone();
+}
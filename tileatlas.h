@@ -0,0 +1,71 @@
+#ifndef TILEATLAS_H
+#define TILEATLAS_H
+
+#include <QObject>
+#include <QPixmap>
+#include <QImage>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QVector>
+#include <QRect>
+#include <QMutex>
+#include <QThreadPool>
+
+class QPainter;
+
+/*!
+ * \brief TileAtlas is a shared cache of downscaled images for image Plates
+ *
+ * an image is read, hashed and decoded on a background thread pool,
+ *      so the UI thread never waits for a disk or a decoder
+ * a decoded image is downscaled once (right in the decoder) and packed
+ *      into a big atlas page, the pages are keyed by the content hash,
+ *      so equal files are decoded and stored only once
+ * a Plate paints its tile with a single drawPixmap() from a shared page
+ *
+ * see tileatlas.cpp
+ */
+class TileAtlas : public QObject
+{
+    Q_OBJECT
+public:
+    static const int TILE_SIDE = 44;    ///< the max side of a tile in pixels (fits a 50x50 Plate)
+    static const int PAGE_SIDE = 1024;  ///< the side of an atlas page in pixels
+
+    static TileAtlas *instance();       ///< see tileatlas.cpp
+    ~TileAtlas() override;
+
+    void request(const QString &path);                                          ///< see tileatlas.cpp
+    bool isReady(const QString &path) const;                                    ///< see tileatlas.cpp
+    void draw(QPainter *painter, const QRect &target, const QString &path) const; ///< see tileatlas.cpp
+
+    bool claim(const QByteArray &hash); ///< is used by decoders, see tileatlas.cpp
+signals:
+    void tileReady(const QString &path); ///< a tile for the path was packed and can be drawn
+private slots:
+    void tileDecoded(const QString &path, const QByteArray &hash, const QImage &tile); ///< see tileatlas.cpp
+private:
+    explicit TileAtlas(QObject *parent = nullptr);
+
+    /*!
+     * \brief a place of a tile in the atlas
+     */
+    struct Slot {
+        int page;   ///< index in pages
+        QRect rect; ///< the tile's rect in the page
+    };
+
+    QThreadPool pool;                           ///< decoders are run here
+    QVector<QPixmap> pages;                     ///< atlas pages, the last one is being filled
+    int cellsUsed;                              ///< how many cells of the last page are taken
+    QHash<QByteArray, Slot> packed;             ///< content hash -> a packed tile
+    QHash<QString, QByteArray> hashes;          ///< path -> content hash (only for the decoded paths)
+    QMultiHash<QByteArray, QString> waiting;    ///< paths which content is still being decoded by another decoder
+    QSet<QString> requested;                    ///< paths already sent to the pool
+
+    QMutex claimedMutex;                        ///< claimed is shared with the decoders
+    QSet<QByteArray> claimed;                   ///< hashes somebody has already started to decode
+};
+
+#endif // TILEATLAS_H